@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "collision.h"
+#include "polygon.h"
+#include "vector.h"
+
+// Microbenchmark for find_collision() and find_circle_polygon_collision().
+// Reports the time per call and, when built with -fsanitize=address
+// (the default in the Makefile), the number of heap allocations per call.
+// Exits with status 1 if either allocated at all.
+
+const size_t BENCH_ITERATIONS = 100000;
+// The ball is approximated by a polygon with this many sides
+const size_t BENCH_CIRCLE_SIDES = 40;
+
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BENCH_COUNT_ALLOCATIONS
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#define BENCH_COUNT_ALLOCATIONS
+#endif
+
+size_t allocations = 0;
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+// Provided by the sanitizer runtime; see <sanitizer/allocator_interface.h>
+int __sanitizer_install_malloc_and_free_hooks(
+    void (*malloc_hook)(const volatile void *, size_t),
+    void (*free_hook)(const volatile void *)
+);
+
+void count_malloc(const volatile void *ptr, size_t size) {
+    allocations++;
+}
+
+void count_free(const volatile void *ptr) {}
+#endif
+
+polygon_t *make_regular_polygon(size_t sides, double radius, vector_t center) {
+    polygon_t *shape = polygon_init(sides);
+    for (size_t i = 0; i < sides; i++) {
+        double angle = 2 * M_PI * i / sides;
+        polygon_add(shape, vec_add(center, vec_init(radius * cos(angle), radius * sin(angle))));
+    }
+    return shape;
+}
+
+/**
+ * Times BENCH_ITERATIONS calls of find_collision() on two shapes
+ * and prints the time and allocations per call.
+ * Returns the number of allocations made during the calls.
+ */
+size_t bench(const char *name, const polygon_t *shape1, const polygon_t *shape2) {
+    size_t collided = 0;
+    size_t start_allocations = allocations;
+    clock_t start = clock();
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        collided += find_collision(shape1, shape2).collided;
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    size_t used = allocations - start_allocations;
+    printf("%-12s %8.1f ns/call  %.2f allocations/call  (collided %zu)\n",
+           name, seconds / BENCH_ITERATIONS * 1e9, (double) used / BENCH_ITERATIONS, collided);
+    return used;
+}
+
+/**
+ * Like bench(), but for the analytic test of a circle against a polygon.
+ */
+size_t bench_circle(const char *name, vector_t center, double radius, const polygon_t *shape) {
+    size_t collided = 0;
+    size_t start_allocations = allocations;
+    clock_t start = clock();
+    for (size_t i = 0; i < BENCH_ITERATIONS; i++) {
+        collided += find_circle_polygon_collision(center, radius, shape).collided;
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+    size_t used = allocations - start_allocations;
+    printf("%-12s %8.1f ns/call  %.2f allocations/call  (collided %zu)\n",
+           name, seconds / BENCH_ITERATIONS * 1e9, (double) used / BENCH_ITERATIONS, collided);
+    return used;
+}
+
+int main(int argc, char *argv[]) {
+#ifdef BENCH_COUNT_ALLOCATIONS
+    __sanitizer_install_malloc_and_free_hooks(count_malloc, count_free);
+#else
+    puts("Allocation counting needs -fsanitize=address; only timing calls");
+#endif
+    polygon_t *ball = make_regular_polygon(BENCH_CIRCLE_SIDES, 10, vec_init(0, 0));
+    polygon_t *near_ground = make_regular_polygon(4, 100, vec_init(0, -105));
+    polygon_t *far_ground = make_regular_polygon(4, 100, vec_init(0, -500));
+
+    size_t used = 0;
+    // Touching shapes check every axis
+    used += bench("overlapping", ball, near_ground);
+    // Separated shapes stop at the first separating axis
+    used += bench("separated", ball, far_ground);
+    // The same ball as a true circle only checks the ground's edges
+    used += bench_circle("circle", vec_init(0, 0), 10, near_ground);
+
+    polygon_free(ball);
+    polygon_free(near_ground);
+    polygon_free(far_ground);
+    return used == 0 ? 0 : 1;
+}
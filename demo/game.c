@@ -19,6 +19,7 @@
 #include "physics.h"
 #include "terrain.h"
 #include "level_handlers.h"
+#include "level_file.h"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
@@ -39,11 +40,77 @@ const double LARGE_MASS = INFINITY;
 const double WALL_THICKNESS = 10;
 const double TRAIL_SIZE = 6;
 const double GRAV_VAL = 1800;
+// Physics runs in fixed steps of this many seconds (240 Hz)
+const double PHYSICS_DT = 1.0 / 240;
+// After a hitch, at most this many steps are run in one batch;
+// any further backlog is dropped rather than simulated
+const int MAX_STEPS_PER_BATCH = 8;
 size_t LEVEL = 1;
+// The current level as it was built, so retrying it only restores the ball
+// and collisions instead of rebuilding the level
+scene_snapshot_t *level_start = NULL;
+
+
+/**
+ * The level after the current one, read and parsed on its own thread
+ * while the current one is played, so moving on to it only builds it.
+ */
+typedef struct level_preload {
+    // The level's file, or NULL if no level has been preloaded
+    const char *path;
+    level_t *level;
+    // Running or not yet waited for; NULL otherwise
+    SDL_Thread *thread;
+} level_preload_t;
+
+level_preload_t preload = {.path = NULL, .level = NULL, .thread = NULL};
+
+int load_level_file(void *aux) {
+    level_preload_t *preload = aux;
+    preload->level = level_load(preload->path);
+    return 0;
+}
+
+/**
+ * Waits for the preloading thread, if any,
+ * and hands its level to generate_level().
+ */
+void finish_preload(void) {
+    if (preload.thread == NULL) {
+        return;
+    }
+    SDL_WaitThread(preload.thread, NULL);
+    preload.thread = NULL;
+    add_level_prototype(preload.path, preload.level);
+    preload.level = NULL;
+}
+
+/**
+ * Starts preloading the level after the scene's current one, if there is one.
+ */
+void start_preload(scene_t *scene) {
+    size_t level = scene_get_level(scene);
+    if (level >= (size_t) NUM_LEVELS || preload.path == level_path(level + 1)) {
+        return;
+    }
+    finish_preload();
+    preload.path = level_path(level + 1);
+    preload.thread = SDL_CreateThread(load_level_file, "level preload", &preload);
+    // Without the thread, the level is just loaded when it is reached
+}
+
+/**
+ * Called whenever a level has been built: saves the snapshot
+ * that retries restore, and starts preloading the next level.
+ */
+void level_started(scene_t *scene) {
+    free(level_start);
+    level_start = scene_snapshot(scene);
+    start_preload(scene);
+}
 
 void handler(char key, key_event_type_t type, double held_time, scene_t *scene) {
     body_t *golfball = scene_get_body(scene, 0);
-    char *filepath = "../resources/popsound.wav";
     if (type == KEY_PRESSED) {
         if (key == RIGHT_ARROW) {
             if (scene_get_state(scene) == 0) {
@@ -51,7 +118,7 @@ void handler(char key, key_event_type_t type, double held_time, scene_t *scene)
                 body_translate(golfball, vec_init(0, 10));
                 body_set_velocity(golfball, right_v);
                 scene_add_point(scene);
-                sdl_load_sound(scene, filepath, 50, 4);
+                sdl_play_sound(SOUND_FLAP);
             }
         }
         else if (key == LEFT_ARROW) {
@@ -60,7 +127,7 @@ void handler(char key, key_event_type_t type, double held_time, scene_t *scene)
                 body_translate(golfball, vec_init(0, 10));
                 body_set_velocity(golfball, left_v);
                 scene_add_point(scene);
-                sdl_load_sound(scene, filepath, 50, 4);
+                sdl_play_sound(SOUND_FLAP);
             }
         }
         else if (key == UP_ARROW) {
@@ -72,59 +139,143 @@ void handler(char key, key_event_type_t type, double held_time, scene_t *scene)
                     scene_set_state(scene, 2);
                 }
                 else if (scene_get_state(scene) == 1) {
+                    // Usually finished long ago, while the level was played
+                    finish_preload();
                     scene_add_level(scene);
                     scene_set_points(scene, 0);
                     body_set_velocity(golfball, VEC_ZERO);
                     scene_set_state(scene, 0);
+                    level_started(scene);
                 }
             }  
         }
         else if (key == SPACE) {
-            Mix_HaltChannel(7);
+            sdl_stop_sound(SOUND_INTRO);
             if (scene_get_state(scene) == -5) {
                 scene_set_state(scene, 0);
             }
             else {
                 if(scene_get_state(scene) == -1 || 1) {
                     body_set_velocity(golfball, VEC_ZERO);
-                    if(scene_get_level(scene) == 1) {
-                        scene_set_level(scene, 1);
-                        reset_scene(scene);
-                        build_level(scene);
+                    // Only rebuilt if a body was removed since the level started
+                    if (scene_restore(scene, level_start)) {
+                        scene_set_points(scene, 0);
+                        scene_set_state(scene, 0);
                     }
                     else {
-                        scene_set_level(scene, scene_get_level(scene) - 1);
-                        scene_add_level(scene);
+                        if(scene_get_level(scene) == 1) {
+                            scene_set_level(scene, 1);
+                            reset_scene(scene);
+                            build_level(scene);
+                        }
+                        else {
+                            scene_set_level(scene, scene_get_level(scene) - 1);
+                            scene_add_level(scene);
+                        }
+                        scene_set_points(scene, 0);
+                        scene_set_state(scene, 0);
+                        level_started(scene);
                     }
-                    scene_set_points(scene, 0);
-                    scene_set_state(scene, 0);
                 }  
             }
         }
         else if (key == Q_CHARACTER) {
-            scene_free(scene);
-            SDL_Quit();
-            exit(0);
+            sdl_request_quit();
         }
     }
 }
 
+/**
+ * What the simulation thread shares with the main thread,
+ * which handles input and draws.
+ */
+typedef struct simulation {
+    scene_t *scene;
+    body_t *player;
+    // Held while the scene is being ticked or changed by a key press
+    SDL_mutex *lock;
+    // Set by the main thread when the window is closed
+    SDL_atomic_t done;
+} simulation_t;
+
+/**
+ * Runs the physics at a fixed rate until the game is closed,
+ * publishing a snapshot for the main thread to draw after each batch of ticks.
+ */
+int simulate(void *aux) {
+    simulation_t *simulation = aux;
+    scene_t *scene = simulation->scene;
+    double accumulator = 0.0;
+    time_since_last_tick();
+    while (!SDL_AtomicGet(&simulation->done)) {
+        accumulator += time_since_last_tick();
+        if (accumulator < PHYSICS_DT) {
+            SDL_Delay(1);
+            continue;
+        }
+        SDL_LockMutex(simulation->lock);
+        int steps = 0;
+        while (accumulator >= PHYSICS_DT && steps < MAX_STEPS_PER_BATCH) {
+            if (scene_get_state(scene) == 0) {
+                do_gravity(simulation->player, GRAV_VAL, PHYSICS_DT);
+            }
+            scene_tick(scene, PHYSICS_DT);
+            accumulator -= PHYSICS_DT;
+            steps++;
+        }
+        if (scene_get_state(scene) == 1) {
+            // Stops the ball from "rolling" once the level is won
+            body_set_velocity(simulation->player, VEC_ZERO);
+        }
+        sdl_publish_scene(scene);
+        SDL_UnlockMutex(simulation->lock);
+        if (accumulator >= PHYSICS_DT) {
+            accumulator = fmod(accumulator, PHYSICS_DT);
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     sdl_init(VEC_ZERO, SCREEN_SIZE);
 
     scene_t *scene = scene_init();
+    // Held for the whole session, so no texture is decoded more than once,
+    // and none is freed while a published snapshot may still draw it
+    list_t *level_textures = load_level_textures();
 
-    body_t *player = build_level(scene);
+    simulation_t simulation = {
+        .scene = scene,
+        .player = build_level(scene),
+        .lock = SDL_CreateMutex()
+    };
+    assert(simulation.lock != NULL);
+    SDL_AtomicSet(&simulation.done, 0);
+    level_started(scene);
     sdl_on_key(handler, scene);
-    double clock = 0.0;
-    while (!sdl_is_done(scene)) {
-        double dt = time_since_last_tick();
-        clock += dt;
-        if (scene_get_state(scene) == 0) {
-            do_gravity(player, GRAV_VAL, dt);
+
+    // Physics runs on its own thread, so presenting a frame never delays a tick
+    sdl_publish_scene(scene);
+    SDL_Thread *simulation_thread = SDL_CreateThread(simulate, "simulation", &simulation);
+    assert(simulation_thread != NULL);
+    while (true) {
+        // Key presses change the scene, so they wait for the current ticks
+        SDL_LockMutex(simulation.lock);
+        bool done = sdl_is_done(scene);
+        SDL_UnlockMutex(simulation.lock);
+        if (done) {
+            break;
         }
-        scene_tick(scene, dt);
-        sdl_render_scene(scene);
+        sdl_render_snapshot(scene, PHYSICS_DT);
     }
+    SDL_AtomicSet(&simulation.done, 1);
+    SDL_WaitThread(simulation_thread, NULL);
+    SDL_DestroyMutex(simulation.lock);
+
+    finish_preload();
+    free(level_start);
     scene_free(scene);
+    free_level_prototypes();
+    list_free(level_textures);
+    sdl_quit();
 }
@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "level_file.h"
+
+// Validates a level file and compiles it to the binary format that
+// generate_level() loads in place of the JSON (see include/level_file.h).
+// Run from the repository root:
+//
+//     bin/levelc resources/level1.txt resources/level1.lvl
+//
+// Prints the first problem found in an invalid level.
+// Exits with status 0 if the compiled level was written, and 1 otherwise.
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: levelc <level.txt> <level.lvl>\n");
+        return 2;
+    }
+    const char *input = argv[1];
+    const char *output = argv[2];
+
+    size_t length = 0;
+    char *json = read_file(input, &length);
+    if (json == NULL) {
+        fprintf(stderr, "%s: could not be read\n", input);
+        return 1;
+    }
+    level_t *level = level_parse_json(json, length);
+    free(json);
+    if (level == NULL) {
+        fprintf(stderr, "%s: not a valid level\n", input);
+        return 1;
+    }
+
+    size_t size = 0;
+    char *compiled = level_compile(level, &size);
+    if (compiled == NULL) {
+        level_free(level);
+        return 1;
+    }
+    // Check the output the way the game will read it
+    char *check = malloc(size);
+    assert(check != NULL);
+    memcpy(check, compiled, size);
+    level_t *loaded = level_load_compiled(check, size);
+    if (loaded == NULL) {
+        fprintf(stderr, "%s: the compiled level does not load\n", input);
+        free(compiled);
+        level_free(level);
+        return 1;
+    }
+    level_free(loaded);
+
+    FILE *f = fopen(output, "wb");
+    bool written = f != NULL && fwrite(compiled, 1, size, f) == size;
+    if (f != NULL && fclose(f) != 0) {
+        written = false;
+    }
+    if (!written) {
+        fprintf(stderr, "%s: could not be written\n", output);
+        remove(output);
+    }
+    else {
+        printf("%s: %zu objects, %zu vertices, %zu bytes (from %zu)\n",
+               output, level->object_count, level->vertex_count, size, length);
+    }
+    free(compiled);
+    level_free(level);
+    return written ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+#include "list.h"
+#include "vector.h"
+#include "sdl_wrapper.h"
+#include "scene.h"
+#include "body.h"
+#include "physics.h"
+#include "level_handlers.h"
+#include "terrain.h"
+
+// Plays one level without a window, audio, or textures, as fast as possible.
+// Run from the repository root (levels are loaded from resources/):
+//
+//     bin/sim <level> <max ticks> [<tick>L | <tick>R ...]
+//
+// e.g. "bin/sim 1 5000 30R 240R 500L" flaps right on ticks 30 and 240
+// and left on tick 500, as if the arrow keys were pressed.
+// Prints the outcome, the number of ticks played, and the physics throughput.
+// Exits with status 0 if the ball reached the hole, and 1 otherwise.
+
+const int NUM_LEVELS = 7;
+
+// These match demo/game.c, so a script plays out the same as the real game
+const vector_t PLAYER_SPEED = {.x = 500, .y = 700};
+const double GRAV_VAL = 1800;
+const double PHYSICS_DT = 1.0 / 240;
+
+typedef struct flap {
+    size_t tick;
+    arrow_key_t key;
+} flap_t;
+
+void usage(void) {
+    fprintf(stderr, "usage: sim <level 1-%d> <max ticks> [<tick>L | <tick>R ...]\n", NUM_LEVELS);
+    exit(2);
+}
+
+size_t parse_count(const char *arg) {
+    char *end;
+    unsigned long value = strtoul(arg, &end, 10);
+    if (end == arg || *end != '\0') {
+        usage();
+    }
+    return value;
+}
+
+/**
+ * Parses a flap like "30R" into the tick and arrow key.
+ */
+flap_t parse_flap(const char *arg) {
+    char *end;
+    unsigned long tick = strtoul(arg, &end, 10);
+    if (end == arg || end[1] != '\0' || (end[0] != 'L' && end[0] != 'R')) {
+        usage();
+    }
+    return (flap_t) {.tick = tick, .key = end[0] == 'L' ? LEFT_ARROW : RIGHT_ARROW};
+}
+
+/**
+ * Does what the game's key handler does when an arrow key is pressed.
+ */
+void flap(scene_t *scene, arrow_key_t key) {
+    body_t *golfball = scene_get_body(scene, 0);
+    vector_t velocity = PLAYER_SPEED;
+    if (key == LEFT_ARROW) {
+        velocity.x *= -1;
+    }
+    body_translate(golfball, vec_init(0, 10));
+    body_set_velocity(golfball, velocity);
+    scene_add_point(scene);
+}
+
+/**
+ * Builds the given level the way the game reaches it.
+ * The ball is only created when level 1 is built.
+ */
+void load_level(scene_t *scene, size_t level) {
+    build_level(scene);
+    if (level > 1) {
+        scene_set_level(scene, level - 1);
+        scene_add_level(scene);
+    }
+    body_set_velocity(scene_get_body(scene, 0), VEC_ZERO);
+    scene_set_points(scene, 0);
+    scene_set_state(scene, 0);
+}
+
+const char *outcome_name(int state) {
+    switch (state) {
+        case 0:
+            return "out of ticks";
+        case -1:
+            return "in the water";
+        default:
+            return "in the hole";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        usage();
+    }
+    size_t level = parse_count(argv[1]);
+    if (level < 1 || level > (size_t) NUM_LEVELS) {
+        usage();
+    }
+    size_t max_ticks = parse_count(argv[2]);
+    size_t num_flaps = argc - 3;
+    flap_t *flaps = malloc(sizeof(flap_t) * (num_flaps + 1));
+    for (size_t i = 0; i < num_flaps; i++) {
+        flaps[i] = parse_flap(argv[i + 3]);
+        if (i > 0 && flaps[i].tick < flaps[i - 1].tick) {
+            fprintf(stderr, "flaps must be in tick order\n");
+            exit(2);
+        }
+    }
+
+    scene_t *scene = scene_init();
+    load_level(scene, level);
+    body_t *player = scene_get_body(scene, 0);
+
+    size_t next_flap = 0;
+    size_t ticks = 0;
+    clock_t start = clock();
+    while (ticks < max_ticks && scene_get_state(scene) == 0) {
+        while (next_flap < num_flaps && flaps[next_flap].tick == ticks) {
+            flap(scene, flaps[next_flap].key);
+            next_flap++;
+        }
+        do_gravity(player, GRAV_VAL, PHYSICS_DT);
+        scene_tick(scene, PHYSICS_DT);
+        ticks++;
+    }
+    double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    int state = scene_get_state(scene);
+    printf("level %zu: %s after %zu ticks (%.2f s of play), %zu flaps\n",
+           level, outcome_name(state), ticks, ticks * PHYSICS_DT, scene_get_points(scene));
+    if (seconds > 0) {
+        printf("%.0f steps/s\n", ticks / seconds);
+    }
+
+    free(flaps);
+    scene_free(scene);
+    free_level_prototypes();
+    return state == 1 || state == 2 ? 0 : 1;
+}
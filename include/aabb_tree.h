@@ -0,0 +1,120 @@
+#ifndef __AABB_TREE_H__
+#define __AABB_TREE_H__
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "list.h"
+#include "vector.h"
+
+/**
+ * A dynamic bounding volume hierarchy of axis-aligned bounding boxes.
+ * Each item is stored in a leaf whose box is "fat": grown by a margin
+ * around the item's real box, so an item that moves a little stays in
+ * its leaf and the tree is only restructured when it moves further.
+ * The tree is kept balanced as items are inserted and removed,
+ * so queries cost time logarithmic in the number of items.
+ * Meant for items that move or are removed, complementing spatial_hash_t.
+ */
+typedef struct aabb_tree aabb_tree_t;
+
+/**
+ * A function which is called for every pair of items whose boxes overlap.
+ *
+ * @param item1 the first item of the pair
+ * @param item2 the second item of the pair
+ * @param aux the auxiliary value passed to aabb_tree_query_pairs()
+ */
+typedef void (*aabb_pair_handler_t)(void *item1, void *item2, void *aux);
+
+/**
+ * Allocates memory for an empty tree.
+ * Asserts that the margin is non-negative and that the memory was allocated.
+ *
+ * @param margin the distance a leaf's box extends past its item's box
+ * @return a pointer to the newly allocated tree
+ */
+aabb_tree_t *aabb_tree_init(double margin);
+
+/**
+ * Releases the memory allocated for a tree.
+ * Does not free the items stored in it.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ */
+void aabb_tree_free(aabb_tree_t *tree);
+
+/**
+ * Removes every item from a tree, keeping its nodes for reuse.
+ * Ids returned before the tree was cleared are no longer valid.
+ * Does not free the items.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ */
+void aabb_tree_clear(aabb_tree_t *tree);
+
+/**
+ * Gets the number of items in a tree.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @return the number of items inserted and not yet removed
+ */
+size_t aabb_tree_size(aabb_tree_t *tree);
+
+/**
+ * Adds an item to a tree.
+ * Asserts that the item is non-NULL.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param item the item to add; the tree does not take ownership of it
+ * @param min the bottom left corner of the item's bounding box
+ * @param max the top right corner of the item's bounding box
+ * @return an id for the item's leaf, to pass to aabb_tree_move() and aabb_tree_remove()
+ */
+size_t aabb_tree_insert(aabb_tree_t *tree, void *item, vector_t min, vector_t max);
+
+/**
+ * Removes an item from a tree.
+ * Asserts that the id belongs to an item in the tree.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param id the id returned when the item was inserted
+ */
+void aabb_tree_remove(aabb_tree_t *tree, size_t id);
+
+/**
+ * Updates the bounding box of an item in a tree.
+ * If the new box still fits in the item's fat box, the tree is unchanged.
+ * Otherwise the item is reinserted with a new fat box; its id stays the same.
+ * Asserts that the id belongs to an item in the tree.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param id the id returned when the item was inserted
+ * @param min the bottom left corner of the item's new bounding box
+ * @param max the top right corner of the item's new bounding box
+ * @return whether the item had to be reinserted
+ */
+bool aabb_tree_move(aabb_tree_t *tree, size_t id, vector_t min, vector_t max);
+
+/**
+ * Finds every item whose fat box overlaps (or touches) the given box,
+ * and appends each one to results.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param min the bottom left corner of the box to query
+ * @param max the top right corner of the box to query
+ * @param results a list that does not own its elements, to append items to
+ */
+void aabb_tree_query(aabb_tree_t *tree, vector_t min, vector_t max, list_t *results);
+
+/**
+ * Calls a handler once for every pair of distinct items in a tree
+ * whose fat boxes overlap (or touch).
+ * The handler must not insert, move, or remove items.
+ *
+ * @param tree a pointer to a tree returned from aabb_tree_init()
+ * @param handler the function to call for each overlapping pair
+ * @param aux an auxiliary value to pass to the handler
+ */
+void aabb_tree_query_pairs(aabb_tree_t *tree, aabb_pair_handler_t handler, void *aux);
+
+#endif // #ifndef __AABB_TREE_H__
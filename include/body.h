@@ -5,6 +5,7 @@
 #include <SDL2/SDL_image.h>
 #include "color.h"
 #include "list.h"
+#include "polygon.h"
 #include "vector.h"
 
 
@@ -16,18 +17,31 @@
  */
 typedef struct body_t body_t;
 
+/**
+ * The part of a body that changes as the scene is simulated.
+ * Saved and restored by scene_snapshot() and scene_restore().
+ */
+typedef struct body_state {
+    vector_t centroid;
+    vector_t previous_centroid;
+    vector_t velocity;
+    double orientation;
+    bool remove;
+} body_state_t;
+
 /**
  * Initializes a body without any info.
  * Acts like body_init_with_info() where info and info_freer are NULL.
  */
-body_t *body_init(list_t *shape, double mass, rgb_color_t color);
+body_t *body_init(polygon_t *shape, double mass, rgb_color_t color);
 
 /**
  * Allocates memory for a body with the given parameters.
  * The body is initially at rest.
  * Asserts that the mass is positive and that the required memory is allocated.
  *
- * @param shape a list of vectors describing the initial shape of the body
+ * @param shape a polygon describing the initial shape of the body;
+ *   the body takes ownership of it
  * @param mass the mass of the body (if INFINITY, stops the body from moving)
  * @param color the color of the body, used to draw it on the screen
  * @param info additional information to associate with the body,
@@ -36,7 +50,7 @@ body_t *body_init(list_t *shape, double mass, rgb_color_t color);
  * @return a pointer to the newly allocated body
  */
 body_t *body_init_with_info(
-    list_t *shape,
+    polygon_t *shape,
     double mass,
     rgb_color_t color,
     void *info,
@@ -51,13 +65,51 @@ body_t *body_init_with_info(
 void body_free(body_t *body);
 
 /**
- * Gets the current shape of a body.
- * Returns a newly allocated vector list, which must be list_free()d.
+ * Gets a copy of the current shape of a body.
+ * Returns a newly allocated polygon, which must be polygon_free()d.
+ * Only use this when the caller needs to own or modify the shape;
+ * otherwise prefer body_get_shape_view(), which does not allocate.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the polygon describing the body's current position
+ */
+polygon_t *body_get_shape(body_t *body);
+
+/**
+ * Gets a read-only view of the current shape of a body without copying it.
+ * Bodies store their shape relative to their centroid, and the world
+ * vertices are only recomputed here, the first time they are needed after
+ * the body moves or rotates. A body that never moves never recomputes them.
+ * The view is borrowed from the body: it must not be freed, and it is only
+ * valid until the body is next moved, rotated, or freed.
  *
  * @param body a pointer to a body returned from body_init()
  * @return the polygon describing the body's current position
  */
-list_t *body_get_shape(body_t *body);
+const polygon_t *body_get_shape_view(body_t *body);
+
+/**
+ * Gets the axis-aligned bounding box of a body's current shape.
+ * The box is cached with the shape's world vertices, so it is only
+ * recomputed after the body moves or rotates.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param min set to the bottom left corner of the box
+ * @param max set to the top right corner of the box
+ */
+void body_get_bounds(body_t *body, vector_t *min, vector_t *max);
+
+/**
+ * Gets a body's shape split into triangles, for drawing.
+ * The shape is triangulated the first time this is called, and the result
+ * is kept for the life of the body, since a body's shape never changes;
+ * moving or rotating the body does not change which vertices form each triangle.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return polygon_size(body_get_shape_view(body)) - 2 triangles, as three
+ * indices each into the vertices of the body's shape; owned by the body
+ */
+const size_t *body_get_triangles(body_t *body);
 
 /**
  * Gets all shapes the body has collided with in the previous tick.
@@ -69,6 +121,25 @@ list_t *body_get_collisions(body_t *body);
 
 double body_get_bounding_radius(body_t *body);
 
+/**
+ * Makes a body collide as a true circle centered at its centroid,
+ * instead of as its polygon shape.
+ * The shape is still used for drawing, so it should approximate the circle.
+ * Should be called while the shape is centered on the centroid.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param radius the radius of the circle; must be positive
+ */
+void body_set_circle(body_t *body, double radius);
+
+/**
+ * Gets the radius of a body's circle collider.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the radius passed to body_set_circle(), or 0 if the body collides as a polygon
+ */
+double body_get_circle_radius(body_t *body);
+
 bool body_collided(body_t *body);
 
 void body_set_collided(body_t *body, bool val);
@@ -84,6 +155,15 @@ void body_set_collided(body_t *body, bool val);
  */
 vector_t body_get_centroid(body_t *body);
 
+/**
+ * Gets a body's center of mass as it was before the latest body_tick().
+ * body_set_centroid() moves it too, so jumps are not drawn as motion.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's previous centroid
+ */
+vector_t body_get_previous_centroid(body_t *body);
+
 /**
  * Gets the current velocity of a body.
  *
@@ -159,6 +239,7 @@ void body_set_collisions(body_t *body, list_t *col_list);
 
 /**
  * Adds an anchor to the main body anchor list.
+ * The anchored body moves with the main body, but is not freed with it.
  */
 void body_add_anchor(body_t *body, body_t *anchor);
 
@@ -171,6 +252,14 @@ void body_set_color(body_t *body, rgb_color_t color);
 
 void body_set_surface(body_t *body, SDL_Surface *surf);
 
+/**
+ * Sets the texture a body is drawn with.
+ * The body takes over one reference to the texture and releases it
+ * with sdl_free_texture() when it is freed or given another texture.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param tex a texture from sdl_load_texture(), or NULL for none
+ */
 void body_set_texture(body_t *body, SDL_Texture *tex);
 
 /**
@@ -202,6 +291,24 @@ void body_rotate_external(body_t *body, double angle, vector_t pivot);
 void body_set_rotation(body_t *body, double angle);
 
 double body_get_rotation(body_t *body);
+
+/**
+ * Gets the state that a tick of the simulation can change.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @return the body's centroids, velocity, orientation, and removal mark
+ */
+body_state_t body_get_state(body_t *body);
+
+/**
+ * Puts a body back in a state from body_get_state().
+ * Bodies anchored to it move along with it, and any forces and impulses
+ * accumulated for the current tick are discarded.
+ *
+ * @param body a pointer to a body returned from body_init()
+ * @param state the state to restore
+ */
+void body_set_state(body_t *body, body_state_t state);
 /**
  * Applies a force to a body over the current tick.
  * If multiple forces are applied in the same tick, they should be added.
@@ -2,7 +2,7 @@
 #define __COLLISION_H__
 
 #include <stdbool.h>
-#include "list.h"
+#include "polygon.h"
 #include "vector.h"
 
 /**
@@ -23,7 +23,7 @@ typedef struct {
 
 /**
  * Computes the status of the collision between two convex polygons.
- * The shapes are given as lists of vertices in counterclockwise order.
+ * The shapes are given as polygons with vertices in counterclockwise order.
  * There is an edge between each pair of consecutive vertices,
  * and one between the first vertex and the last vertex.
  *
@@ -32,6 +32,33 @@ typedef struct {
  * @return whether the shapes are colliding, and if so, the collision axis.
  * The axis should be a unit vector pointing from shape1 towards shape2.
  */
-collision_info_t find_collision(list_t *shape1, list_t *shape2);
+collision_info_t find_collision(const polygon_t *shape1, const polygon_t *shape2);
+
+/**
+ * Computes the status of the collision between two circles.
+ *
+ * @param center1 the center of the first circle
+ * @param radius1 the radius of the first circle
+ * @param center2 the center of the second circle
+ * @param radius2 the radius of the second circle
+ * @return whether the circles are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from the first center towards the second.
+ */
+collision_info_t find_circle_collision(vector_t center1, double radius1, vector_t center2, double radius2);
+
+/**
+ * Computes the status of the collision between a circle and a convex polygon,
+ * using the point on the polygon's boundary closest to the circle's center.
+ * This checks each edge once, and the axis is exact rather than
+ * one of the edge normals of a polygon approximating the circle.
+ * The polygon's vertices may be in either order.
+ *
+ * @param center the center of the circle
+ * @param radius the radius of the circle
+ * @param shape the polygon
+ * @return whether the shapes are colliding, and if so, the collision axis.
+ * The axis is a unit vector pointing from the circle towards the polygon.
+ */
+collision_info_t find_circle_polygon_collision(vector_t center, double radius, const polygon_t *shape);
 
 #endif // #ifndef __COLLISION_H__
@@ -18,7 +18,8 @@
  * @param radius the radius of the golf ball, wings have 3 times the radius
  * @param color the RGB color of the golf ball, wings are always light grey
  * @param mass the ball's mass, wings have the same mass (total mass = 3* mass)
- * @return a pointer to the newly created golf ball compoundbody
+ * @return a list of the ball's bodies, which does not own them;
+ *   free it with list_free() once they are added to a scene
  */
 list_t *create_golf_ball(double radius, rgb_color_t color, double mass, vector_t location);
 
@@ -28,7 +29,8 @@ list_t *create_golf_ball(double radius, rgb_color_t color, double mass, vector_t
  * @param radius the radius of the target hole
  * @param color the RGB color of the hole, normally black
  * @param mass the hole's mass, can simulate a slope towards it
- * @return a pointer to the newly created golf hole compound body
+ * @return a list of the hole's bodies, which does not own them;
+ *   free it with list_free() once they are added to a scene
  */
 list_t *create_golf_hole(double radius, rgb_color_t color, double mass);
 
@@ -87,6 +87,23 @@ void drag_force_creator(drag_aux_t *aux, list_t *bodies);
  */
 void collision_force_creator(collision_aux_t *aux, list_t *bodies, scene_t *scene);
 
+/**
+ * Gets whether the bodies of a collision were touching after the last tick.
+ * The handler is only called again once they have separated.
+ *
+ * @param aux the aux of a force bundle whose forcer is collision_force_creator
+ */
+bool collision_aux_get_collided(collision_aux_t *aux);
+
+/**
+ * Sets whether the bodies of a collision were touching after the last tick,
+ * e.g. to restore a snapshot of the scene.
+ *
+ * @param aux the aux of a force bundle whose forcer is collision_force_creator
+ * @param collided whether the bodies were touching
+ */
+void collision_aux_set_collided(collision_aux_t *aux, bool collided);
+
 /**
  * Adds a force creator to a scene that applies gravity between two bodies.
  * The force creator will be called each tick
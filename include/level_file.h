@@ -0,0 +1,125 @@
+#ifndef __LEVEL_FILE_H__
+#define __LEVEL_FILE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector.h"
+
+/**
+ * The kinds of objects a level file places.
+ * Stored as numbers in compiled levels, so new kinds must be added at the end.
+ */
+typedef enum {
+    LEVEL_BALL,
+    LEVEL_HOLE,
+    LEVEL_GRASS,
+    LEVEL_CIRCLE_GRASS,
+    LEVEL_WATER,
+    LEVEL_SAND,
+    LEVEL_POWER,
+    LEVEL_TELEPORT,
+    NUM_LEVEL_OBJECT_TYPES
+} level_object_type_t;
+
+/**
+ * One object of a level.
+ * This is also its layout in a compiled level file, so it has no padding
+ * and only fixed-size fields.
+ */
+typedef struct level_object {
+    // A level_object_type_t
+    uint32_t type;
+    // The object's shape, as a range of the level's vertices.
+    // Empty for objects that are only placed at their position.
+    uint32_t shape_first;
+    uint32_t shape_count;
+    // The exit portal's shape, for LEVEL_TELEPORT; empty otherwise
+    uint32_t out_first;
+    uint32_t out_count;
+    uint32_t reserved;
+    vector_t position;
+    // The direction the ball leaves the exit portal, for LEVEL_TELEPORT
+    vector_t direction;
+    // The radius, for LEVEL_CIRCLE_GRASS
+    double radius;
+} level_object_t;
+
+/**
+ * A level's size and objects, read from a JSON level file
+ * or a compiled one made by bin/levelc.
+ */
+typedef struct level {
+    vector_t bounds;
+    size_t object_count;
+    level_object_t *objects;
+    // The vertices of every object's shapes, one after the other
+    size_t vertex_count;
+    vector_t *vertices;
+    // The compiled file that objects and vertices point into,
+    // or NULL if they were allocated on their own
+    char *data;
+} level_t;
+
+/**
+ * Reads a whole file into memory with a single read, sized by fstat().
+ * The contents are NUL-terminated, but the length excludes the terminator.
+ *
+ * @param path the file to read
+ * @param length set to the number of bytes read
+ * @return the contents, which the caller must free, or NULL if the file
+ * could not be opened or read
+ */
+char *read_file(const char *path, size_t *length);
+
+/**
+ * Parses and validates a level in the JSON format of resources/level*.txt.
+ * Prints a message to stderr describing the first problem, if any.
+ *
+ * @param json the level's JSON text
+ * @param length the length of json, in bytes
+ * @return the level, or NULL if it is not a valid level
+ */
+level_t *level_parse_json(const char *json, size_t length);
+
+/**
+ * Encodes a level in the compiled format: a header, then the object table,
+ * then the vertices, all little-endian.
+ * Returns NULL on a big-endian machine, which cannot write the format directly.
+ *
+ * @param level the level to encode
+ * @param size set to the size of the encoding, in bytes
+ * @return the encoding, which the caller must free
+ */
+char *level_compile(const level_t *level, size_t *size);
+
+/**
+ * Loads a compiled level in place: the level's objects and vertices
+ * point into the data, which the level takes ownership of.
+ * Checks the header and that every range is within the data.
+ * Prints a message to stderr describing the first problem, if any.
+ *
+ * @param data the compiled level, from level_compile(); freed if it is invalid
+ * @param size the size of data, in bytes
+ * @return the level, or NULL if the data is not a valid compiled level
+ */
+level_t *level_load_compiled(char *data, size_t size);
+
+/**
+ * Loads a level given the path of its JSON file.
+ * Uses the compiled file next to it (the same name ending in .lvl
+ * instead of .txt) if there is one, and the JSON file otherwise.
+ *
+ * @param path the path of the level's JSON file
+ * @return the level, or NULL if neither file could be loaded
+ */
+level_t *level_load(const char *path);
+
+/**
+ * Releases the memory allocated for a level.
+ *
+ * @param level a level returned from one of the functions above
+ */
+void level_free(level_t *level);
+
+#endif // #ifndef __LEVEL_FILE_H__
@@ -40,6 +40,15 @@ void power_up(body_t *ball, body_t *target, vector_t axis, void *aux);
 void sanded(body_t *ball, body_t *target, vector_t axis, void *aux);
 
 
+/**
+ * Loads every texture that levels use and keeps a reference to each.
+ * While the list is alive, the bodies of each new level share the cached
+ * textures, so switching levels does not decode any images.
+ *
+ * @return a list of the textures; list_free() releases them
+ */
+list_t *load_level_textures(void);
+
 /**
  * A function called when a collision occurs.
  * @param scene the game scene
@@ -49,4 +58,12 @@ void sanded(body_t *ball, body_t *target, vector_t axis, void *aux);
 
 body_t *build_level(scene_t *scene);
 
+/**
+ * Gets the path of a level's JSON file, which build_level() passes to generate_level().
+ *
+ * @param level the level, from 1 to the number of levels
+ * @return the path, which is never freed
+ */
+const char *level_path(size_t level);
+
 #endif // ifndef __LEVEL_HANDLERS_H__
\ No newline at end of file
@@ -36,6 +36,14 @@ list_t *list_init(size_t initial_size, free_func_t freer);
  */
 void list_free(list_t *list);
 
+/**
+ * Removes every element from a list, keeping its capacity for reuse.
+ * If the list has a freer, it is called on each removed element.
+ *
+ * @param list a pointer to a list returned from list_init()
+ */
+void list_clear(list_t *list);
+
 /**
  * Gets the size of a list (the number of occupied elements).
  * Note that this is NOT the list's capacity.
@@ -2,6 +2,7 @@
 #define __PHYSICS_H__
 
 #include "list.h"
+#include "polygon.h"
 #include "color.h"
 #include "body.h"
 
@@ -29,11 +30,11 @@ body_t *do_gravity(body_t *star, double gravity, double dt);
 /**
  * Checks if a body is out of the window.
  *
- * @param star The colliding polygon body.
+ * @param star The polygon to check.
  * @param min The vector defining minimum x, y bounds.
  * @param max The vector defining maximum x, y bounds.
  * @return True if the shape is off screen. False otherwise.
  */
-bool check_offscreen(list_t *star, vector_t min, vector_t max);
+bool check_offscreen(const polygon_t *star, vector_t min, vector_t max);
 
 #endif // #ifndef __PHYSICS_H__
\ No newline at end of file
@@ -1,49 +1,174 @@
 #ifndef __POLYGON_H__
 #define __POLYGON_H__
 
-#include "list.h"
+#include <stddef.h>
 #include "vector.h"
 
+/**
+ * A polygon whose vertices are stored inline in one contiguous array.
+ * The polygon and its vertices live in a single allocation, so walking
+ * the vertices is one linear pass instead of one pointer chase per vertex.
+ * The capacity is fixed when the polygon is created.
+ *
+ * Functions taking a const polygon_t * only read the polygon, so they accept
+ * borrowed views such as the one returned by body_get_shape_view().
+ */
+typedef struct polygon polygon_t;
+
+/**
+ * Allocates memory for a new polygon with space for the given number of vertices.
+ * The polygon is initially empty.
+ * Asserts that the required memory was allocated.
+ *
+ * @param capacity the maximum number of vertices the polygon can hold
+ * @return a pointer to the newly allocated polygon
+ */
+polygon_t *polygon_init(size_t capacity);
+
+/**
+ * Releases the memory allocated for a polygon.
+ *
+ * @param polygon a pointer to a polygon returned from polygon_init()
+ */
+void polygon_free(polygon_t *polygon);
+
+/**
+ * Allocates a new polygon holding the same vertices as the given one.
+ *
+ * @param polygon a pointer to a polygon returned from polygon_init()
+ * @return a newly allocated copy, which must be polygon_free()d
+ */
+polygon_t *polygon_copy(const polygon_t *polygon);
+
+/**
+ * Gets the number of vertices in a polygon.
+ *
+ * @param polygon a pointer to a polygon returned from polygon_init()
+ * @return the number of vertices added with polygon_add()
+ */
+size_t polygon_size(const polygon_t *polygon);
+
+/**
+ * Gets the vertex at a given index in a polygon.
+ * Asserts that the index is valid.
+ *
+ * @param polygon a pointer to a polygon returned from polygon_init()
+ * @param index the index of the vertex (the first vertex is at 0)
+ * @return the vertex at the given index
+ */
+vector_t polygon_get(const polygon_t *polygon, size_t index);
+
+/**
+ * Replaces the vertex at a given index in a polygon.
+ * Asserts that the index is valid.
+ *
+ * @param polygon a pointer to a polygon returned from polygon_init()
+ * @param index the index of the vertex to replace
+ * @param vertex the new vertex
+ */
+void polygon_set(polygon_t *polygon, size_t index, vector_t vertex);
+
+/**
+ * Appends a vertex to the end of a polygon.
+ * Asserts that the polygon has room for it.
+ *
+ * @param polygon a pointer to a polygon returned from polygon_init()
+ * @param vertex the vertex to add
+ */
+void polygon_add(polygon_t *polygon, vector_t vertex);
+
+/**
+ * Gets the polygon's vertex array, for walking all vertices in one pass.
+ * The array holds polygon_size() vertices and is owned by the polygon;
+ * it is read-only, so use polygon_set() or polygon_translate() to modify it.
+ *
+ * @param polygon a pointer to a polygon returned from polygon_init()
+ * @return the first of the polygon's contiguous vertices
+ */
+const vector_t *polygon_vertices(const polygon_t *polygon);
+
+/**
+ * Computes the axis-aligned bounding box of a polygon.
+ * Asserts that the polygon has at least one vertex.
+ *
+ * @param polygon the polygon to bound
+ * @param min set to the bottom left corner of the box
+ * @param max set to the top right corner of the box
+ */
+void polygon_bounds(const polygon_t *polygon, vector_t *min, vector_t *max);
+
 /**
  * Computes the area of a polygon.
  * See https://en.wikipedia.org/wiki/Shoelace_formula#Statement.
  *
- * @param polygon the list of vertices that make up the polygon,
- * listed in a counterclockwise direction. There is an edge between
- * each pair of consecutive vertices, plus one between the first and last.
+ * @param polygon the polygon, with vertices listed in a counterclockwise direction.
+ * There is an edge between each pair of consecutive vertices,
+ * plus one between the first and last.
  * @return the area of the polygon
  */
-double polygon_area(list_t *polygon);
+double polygon_area(const polygon_t *polygon);
+
+/**
+ * Computes the area of a polygon, signed by the order of its vertices.
+ *
+ * @param polygon the polygon
+ * @return the area, positive if the vertices are listed counterclockwise
+ * and negative if they are listed clockwise
+ */
+double signed_polygon_area(const polygon_t *polygon);
 
 /**
  * Computes the center of mass of a polygon.
  * See https://en.wikipedia.org/wiki/Centroid#Of_a_polygon.
  *
- * @param polygon the list of vertices that make up the polygon,
- * listed in a counterclockwise direction. There is an edge between
- * each pair of consecutive vertices, plus one between the first and last.
+ * @param polygon the polygon, with vertices listed in a counterclockwise direction.
+ * There is an edge between each pair of consecutive vertices,
+ * plus one between the first and last.
  * @return the centroid of the polygon
  */
-vector_t polygon_centroid(list_t *polygon);
+vector_t polygon_centroid(const polygon_t *polygon);
 
 /**
  * Translates all vertices in a polygon by a given vector.
  * Note: mutates the original polygon.
  *
- * @param polygon the list of vertices that make up the polygon
+ * @param polygon the polygon to translate
  * @param translation the vector to add to each vertex's position
  */
-void polygon_translate(list_t *polygon, vector_t translation);
+void polygon_translate(polygon_t *polygon, vector_t translation);
 
 /**
  * Rotates vertices in a polygon by a given angle about a given point.
  * Note: mutates the original polygon.
  *
- * @param polygon the list of vertices that make up the polygon
+ * @param polygon the polygon to rotate
  * @param angle the angle to rotate the polygon, in radians.
  * A positive angle means counterclockwise.
  * @param point the point to rotate around
  */
-void polygon_rotate(list_t *polygon, double angle, vector_t point);
+void polygon_rotate(polygon_t *polygon, double angle, vector_t point);
+
+/**
+ * Overwrites a polygon with another polygon rotated about the origin,
+ * then translated, in a single pass over the vertices.
+ * Asserts that dest has room for all of source's vertices.
+ *
+ * @param dest the polygon to overwrite
+ * @param source the polygon to transform; it is not modified
+ * @param angle the angle to rotate by, in radians. Positive is counterclockwise.
+ * @param translation the vector to add to each rotated vertex
+ */
+void polygon_transform(polygon_t *dest, const polygon_t *source, double angle, vector_t translation);
+
+/**
+ * Splits a simple polygon into triangles by ear clipping.
+ * Works for concave polygons, listed in either direction.
+ * Each triangle is written as three indices into the polygon's vertices.
+ *
+ * @param polygon the polygon, with at least 3 vertices
+ * @param triangles an array with room for 3 * (polygon_size(polygon) - 2) indices
+ * @return the number of triangles written, which is polygon_size(polygon) - 2
+ */
+size_t polygon_triangulate(const polygon_t *polygon, size_t *triangles);
 
 #endif // #ifndef __POLYGON_H__
@@ -13,14 +13,15 @@
 #include "level_handlers.h"
 #include "elements.h"
 #include "cJSON.h"
+#include "polygon.h"
 
-list_t *create_triangle_shape(double a);
+polygon_t *create_triangle_shape(double a);
 
-list_t *create_oval_shape(double a, double b);
+polygon_t *create_oval_shape(double a, double b);
 
-list_t *create_enemy_shape(double radius);
+polygon_t *create_enemy_shape(double radius);
 
-list_t *create_rectangle_shape(double x, double y);
+polygon_t *create_rectangle_shape(double x, double y);
 
 body_t *create_rectangle(double x, double y, double mass);
 
@@ -32,11 +33,11 @@ body_t *create_enemy(double radius, double mass);
 
 body_t *create_bullet(double x, double y, double mass, bool is_enemy);
 
-list_t *create_circle_shape(double radius);
+polygon_t *create_circle_shape(double radius);
 
-list_t *create_semicircle_shape(double radius);
+polygon_t *create_semicircle_shape(double radius);
 
-list_t *create_nstar_shape(int n, double size);
+polygon_t *create_nstar_shape(int n, double size);
 
 /**
  * Creates a circle object_t
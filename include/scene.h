@@ -3,8 +3,6 @@
 
 #include "body.h"
 #include "list.h"
-#include <SDL2/SDL_mixer.h>
-#include <SDL2/SDL_image.h>
 
 /**
  * A collection of bodies and force creators.
@@ -22,6 +20,14 @@ typedef struct scene scene_t;
  */
 typedef void (*force_creator_t)(void *aux, list_t *list);
 
+/**
+ * The state of a scene's simulation at one moment, in a single allocation.
+ * Holds only what ticking and key presses change: the points, the state,
+ * the camera, the state of each non-static body, and whether each
+ * collision force creator's bodies were touching.
+ */
+typedef struct scene_snapshot scene_snapshot_t;
+
 /**
  * Allocates memory for an empty scene.
  * Makes a reasonable guess of the number of bodies to allocate space for.
@@ -47,8 +53,6 @@ void scene_free(scene_t *scene);
  */
 size_t scene_bodies(scene_t *scene);
 
-void scene_add_sound(scene_t *scene, Mix_Chunk *sound);
-
 size_t scene_background_elements(scene_t *scene);
 
 body_t *scene_get_background_element(scene_t *scene, size_t index);
@@ -61,6 +65,8 @@ force_creator_t get_force_bundle_forcer(force_bundle_t *force_bundle);
 
 list_t *get_force_bundle_bodies(force_bundle_t *force_bundle);
 
+void *get_force_bundle_aux(force_bundle_t *force_bundle);
+
 size_t scene_get_points(scene_t *scene);
 
 size_t scene_get_level(scene_t *scene);
@@ -69,10 +75,6 @@ void reset_scene(scene_t *scene);
 
 bool scene_set_first_try(scene_t *scene, bool retry_first_level);
 
-void scene_set_img(scene_t *scene, SDL_Texture *img);
-
-SDL_Texture *scene_get_img(scene_t *scene);
-
 bool scene_get_first_try(scene_t *scene);
 
 int scene_get_state(scene_t *scene);
@@ -97,6 +99,17 @@ body_t *scene_get_body(scene_t *scene, size_t index);
  */
 void scene_add_body(scene_t *scene, body_t *body);
 
+/**
+ * Adds a body that is expected to be removed during play, e.g. a pickup.
+ * Collision force creators against it are kept in a dynamic AABB tree
+ * by scene_index_static_bodies(), which handles removal in logarithmic time,
+ * instead of the spatial hash used for the rest of the terrain.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param body a pointer to the body to add to the scene
+ */
+void scene_add_removable_body(scene_t *scene, body_t *body);
+
 /**
  * Increases the point in the scene by 1.
  *
@@ -162,6 +175,42 @@ void scene_add_bodies_force_creator(
     free_func_t freer
 );
 
+/**
+ * Moves collision force creators between a moving body and a static
+ * (INFINITY-mass) body into the scene's spatial hash of static terrain.
+ * From then on, scene_tick() only runs such a force creator when the moving
+ * body's bounding box overlaps the grid cells of the static body,
+ * so the cost of a tick grows with the terrain near each moving body
+ * rather than with the size of the level.
+ * Should be called once a level is fully built; force creators that are
+ * already indexed are skipped, so calling it again is harmless.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ */
+void scene_index_static_bodies(scene_t *scene);
+
+/**
+ * The layers a scene is drawn in, from back to front.
+ * Each layer scrolls with the camera at its own rate, for a parallax effect.
+ */
+typedef enum {
+    SCENE_LAYER_BACKGROUND,
+    SCENE_LAYER_BODIES
+} scene_layer_t;
+
+/**
+ * Gets the offset to add to a layer's world coordinates when drawing it.
+ * The camera follows the ball in scene_tick(); bodies themselves are never
+ * moved to follow it, so their shapes only change when they move in the world.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @param layer the layer being drawn
+ * @param alpha how far between the previous tick (0) and the latest one (1)
+ * the camera should be taken from
+ * @return the camera offset, scaled by the layer's parallax factor
+ */
+vector_t scene_get_view_offset(scene_t *scene, scene_layer_t layer, double alpha);
+
 /**
  * Executes a tick of a given scene over a small time interval.
  * This requires executing all the force creators
@@ -174,4 +223,36 @@ void scene_add_bodies_force_creator(
  */
 void scene_tick(scene_t *scene, double dt);
 
+/**
+ * Saves the current state of a scene's simulation.
+ * Static bodies are not saved, since nothing moves them, so the snapshot
+ * is a few hundred bytes and can be taken every tick, e.g. for a rewind buffer.
+ *
+ * @param scene a pointer to a scene returned from scene_init()
+ * @return the snapshot, which the caller must free with free()
+ */
+scene_snapshot_t *scene_snapshot(scene_t *scene);
+
+/**
+ * Gets the size of a snapshot, including everything it holds,
+ * so it can be copied with memcpy().
+ *
+ * @param snapshot a snapshot returned from scene_snapshot()
+ * @return the size of the snapshot in bytes
+ */
+size_t scene_snapshot_size(const scene_snapshot_t *snapshot);
+
+/**
+ * Puts a scene back in the state saved in a snapshot of it.
+ * This only works while the scene has the same bodies and force creators
+ * as when the snapshot was taken: once a body is added or removed
+ * (e.g. a power-up is picked up) or the level is rebuilt,
+ * the snapshot no longer applies and the scene is left unchanged.
+ *
+ * @param scene the scene the snapshot was taken of
+ * @param snapshot a snapshot returned from scene_snapshot()
+ * @return whether the scene was restored
+ */
+bool scene_restore(scene_t *scene, const scene_snapshot_t *snapshot);
+
 #endif // #ifndef __SCENE_H__
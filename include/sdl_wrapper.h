@@ -32,6 +32,21 @@ typedef enum {
     KEY_RELEASED
 } key_event_type_t;
 
+/**
+ * The sounds in the sound bank, which sdl_init() loads.
+ * Each sound has its own mixer channel, so it only interrupts itself.
+ */
+typedef enum {
+    SOUND_INTRO,
+    SOUND_FLAP,
+    SOUND_TELEPORT,
+    SOUND_POWER_UP,
+    SOUND_LEVEL_WIN,
+    SOUND_GAME_WIN,
+    SOUND_LOST,
+    NUM_SOUNDS
+} sound_t;
+
 /**
  * A keypress handler.
  * When a key is pressed or released, the handler is passed its char value.
@@ -45,7 +60,8 @@ typedef enum {
 typedef void (*key_handler_t)(char key, key_event_type_t type, double held_time, scene_t *scene);
 
 /**
- * Initializes the SDL window and renderer.
+ * Initializes the SDL window and renderer, opens the audio device,
+ * and loads every sound in the sound bank.
  * Must be called once before any of the other SDL functions.
  *
  * @param min the x and y coordinates of the bottom left of the scene
@@ -59,6 +75,21 @@ void direction_display(char *message, int text_height, int font_size, int x_pos,
 
 void point_display(char *score);
 
+/**
+ * Draws a line of text in the game font with a single draw call.
+ * The glyphs of each font size are rasterized into an atlas texture
+ * the first time that size is drawn. After that, drawing text does not
+ * rasterize anything or create textures, so the text can change every frame.
+ * Characters outside printable ASCII are drawn as spaces.
+ *
+ * @param message the text to draw
+ * @param x the left edge of the text, in window pixels
+ * @param y the top edge of the text, in window pixels
+ * @param font_size the point size of the font
+ * @param color the color of the text
+ */
+void sdl_draw_text(char *message, int x, int y, int font_size, rgb_color_t color);
+
 /**
  * Processes all SDL events and returns whether the window has been closed.
  * This function must be called in order to handle keypresses.
@@ -67,24 +98,66 @@ void point_display(char *score);
  */
 bool sdl_is_done(scene_t *scene);
 
+/**
+ * Makes sdl_is_done() return true, as if the window had been closed.
+ * Meant for key handlers, so the game shuts down from its main loop
+ * instead of from inside the handler.
+ */
+void sdl_request_quit(void);
+
 /**
  * Clears the screen. Should be called before drawing polygons in each frame.
  */
 void sdl_clear(void);
 
-SDL_Texture *sdl_load_texture(char *filepath);
+/**
+ * The asset functions below are the only ones the libraries call.
+ * library/sdl_headless.c provides no-op versions of them,
+ * so the physics can run without a window, audio, or textures.
+ */
 
-Mix_Chunk *sdl_load_sound(scene_t *scene, char *filepath, int volume, int channel);
+/**
+ * Gets the texture for an image file.
+ * Textures are cached by path: each file is decoded once, and later calls
+ * return the same texture, counting another reference to it.
+ * Asserts that the image could be loaded.
+ *
+ * @param filepath the path of the image file
+ * @return the texture; release it with sdl_free_texture() when done
+ */
+SDL_Texture *sdl_load_texture(char *filepath);
 
-void sdl_free_sound(Mix_Chunk *sound);
+/**
+ * Releases a texture returned from sdl_load_texture().
+ * A cached texture is only destroyed once every reference to it is released.
+ * Does nothing if the texture is NULL.
+ */
+void sdl_free_texture(SDL_Texture *texture);
 
+/**
+ * Starts playing a sound from the sound bank, replacing the sound's
+ * previous playback if it is still going.
+ * Returns immediately and does no file I/O, so it is safe to call
+ * during a physics step. Does nothing if the audio device could not be opened.
+ *
+ * @param sound the sound to play
+ */
+void sdl_play_sound(sound_t sound);
 
 /**
- * Draws a polygon representing the body.
+ * Stops a sound from the sound bank if it is playing.
  *
- * @param body the body whose shape is to be drawm
+ * @param sound the sound to stop
  */
-void sdl_draw_polygon(body_t *body);
+void sdl_stop_sound(sound_t sound);
+
+/**
+ * Frees the sound bank and textures and shuts down SDL
+ * and its image and audio libraries.
+ * Should be called once, after the scene has been freed.
+ */
+void sdl_quit(void);
+
 
 /**
  * Displays the rendered frame on the SDL window.
@@ -93,13 +166,27 @@ void sdl_draw_polygon(body_t *body);
 void sdl_show(void);
 
 /**
- * Draws all bodies in a scene.
- * This internally calls sdl_clear(), sdl_draw_polygon(), and sdl_show(),
- * so those functions should not be called directly.
+ * Copies the state of a scene's bodies, camera, points, and level into
+ * a snapshot, and makes it the latest snapshot for sdl_render_snapshot().
+ * Lets the scene be simulated on one thread while another draws it:
+ * call this from the simulating thread after each batch of ticks,
+ * while nothing else is changing the scene. Does not wait for drawing.
+ *
+ * @param scene the scene to publish
+ */
+void sdl_publish_scene(scene_t *scene);
+
+/**
+ * Draws the latest snapshot published by sdl_publish_scene(),
+ * interpolating between its previous tick and its latest one by the time
+ * since it was published. Does not wait for the simulation.
+ * The background elements are drawn from the scene itself,
+ * so they must only be changed on the thread that calls this.
  *
- * @param scene the scene to draw
+ * @param scene the scene that was published
+ * @param step the length of a tick, in seconds
  */
-void sdl_render_scene(scene_t *scene);
+void sdl_render_snapshot(scene_t *scene, double step);
 
 /**
  * Registers a function to be called every time a key is pressed.
@@ -130,8 +217,9 @@ void sdl_render_scene(scene_t *scene);
 void sdl_on_key(key_handler_t handler, void *aux);
 
 /**
- * Gets the amount of time that has passed since the last time
+ * Gets the amount of wall-clock time that has passed since the last time
  * this function was called, in seconds.
+ * Uses SDL's monotonic high-resolution counter.
  *
  * @return the number of seconds that have elapsed
  */
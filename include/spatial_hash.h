@@ -0,0 +1,83 @@
+#ifndef __SPATIAL_HASH_H__
+#define __SPATIAL_HASH_H__
+
+#include <stddef.h>
+#include "list.h"
+#include "vector.h"
+
+/**
+ * A uniform grid that buckets items by the cells their bounding boxes cover.
+ * Only the cells that are actually occupied are stored, in a hash table,
+ * so the grid is unbounded and its memory grows with the number of items.
+ * Meant for items that rarely move, e.g. static terrain:
+ * a query costs time proportional to the items near the queried box,
+ * not to the total number of items.
+ */
+typedef struct spatial_hash spatial_hash_t;
+
+/**
+ * Allocates memory for an empty spatial hash.
+ * Asserts that the cell size is positive and that the memory was allocated.
+ *
+ * @param cell_size the side length of each square grid cell
+ * @return a pointer to the newly allocated spatial hash
+ */
+spatial_hash_t *spatial_hash_init(double cell_size);
+
+/**
+ * Releases the memory allocated for a spatial hash.
+ * Does not free the items stored in it.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ */
+void spatial_hash_free(spatial_hash_t *hash);
+
+/**
+ * Removes every item from a spatial hash, keeping its memory for reuse.
+ * Does not free the items.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ */
+void spatial_hash_clear(spatial_hash_t *hash);
+
+/**
+ * Gets the number of items in a spatial hash.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @return the number of items inserted and not yet removed
+ */
+size_t spatial_hash_size(spatial_hash_t *hash);
+
+/**
+ * Adds an item to every cell its axis-aligned bounding box overlaps.
+ * Asserts that the item is non-NULL.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param item the item to add; the hash does not take ownership of it
+ * @param min the bottom left corner of the item's bounding box
+ * @param max the top right corner of the item's bounding box
+ */
+void spatial_hash_insert(spatial_hash_t *hash, void *item, vector_t min, vector_t max);
+
+/**
+ * Removes an item from a spatial hash.
+ * If the item is not in the hash, does nothing.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param item the item passed to spatial_hash_insert()
+ */
+void spatial_hash_remove(spatial_hash_t *hash, void *item);
+
+/**
+ * Finds every item whose bounding box overlaps (or touches) the given box.
+ * Each matching item is appended to results exactly once,
+ * even if it shares several cells with the box.
+ *
+ * @param hash a pointer to a spatial hash returned from spatial_hash_init()
+ * @param min the bottom left corner of the box to query
+ * @param max the top right corner of the box to query
+ * @param results a list that does not own its elements, to append items to
+ */
+void spatial_hash_query(spatial_hash_t *hash, vector_t min, vector_t max, list_t *results);
+
+#endif // #ifndef __SPATIAL_HASH_H__
@@ -6,6 +6,7 @@
 #include <math.h>
 #include <stdbool.h>
 #include "render.h"
+#include "level_file.h"
 
 
 /**
@@ -14,17 +15,49 @@
  *
  * @param scene the scene in which the sand should be placed
  * @param ball the golf ball
- * @param shape list of vectors where the sand particles belong
+ * @param shape polygon where the sand particles belong
  * @return a compound body of the sand terrain that can be added to the scene
  */
-body_t *generate_sand(scene_t *scene, body_t *ball, list_t *shape);
+body_t *generate_sand(scene_t *scene, body_t *ball, polygon_t *shape);
 
-body_t *generate_water(scene_t *scene, body_t *ball, list_t *shape);
+body_t *generate_water(scene_t *scene, body_t *ball, polygon_t *shape);
 
-body_t *generate_boost(scene_t *scene, body_t *ball, list_t *shape);
+body_t *generate_boost(scene_t *scene, body_t *ball, polygon_t *shape);
 
+/**
+ * Adds the frame and the objects of a level file to a scene.
+ * Each file is loaded once and kept (see free_level_prototypes()),
+ * so building a level again does not read or parse it.
+ *
+ * @param scene the scene to add the level to
+ * @param ball the golf ball, which is moved to the level's start
+ * @param level the path of the level's JSON file
+ */
 void generate_level(scene_t *scene, body_t *ball, char* level);
 
+/**
+ * Adds the background elements of resources/background.txt to a scene.
+ * They are the same for every level and are kept by reset_scene(),
+ * so this only needs to be called once per scene.
+ *
+ * @param scene the scene to add the background to
+ */
 void generate_background(scene_t *scene);
 
+/**
+ * Frees every level kept by generate_level().
+ * Should be called once, when no more levels will be built.
+ */
+void free_level_prototypes(void);
+
+/**
+ * Keeps a level that was loaded ahead of time, e.g. on another thread,
+ * so generate_level() builds it without reading or parsing the file.
+ * If the file has already been loaded, the new copy is freed instead.
+ *
+ * @param path the path of the level's JSON file, as passed to generate_level()
+ * @param level the level, from level_load(); the kept levels take ownership of it
+ */
+void add_level_prototype(const char *path, level_t *level);
+
 #endif // ifndef __TERRAIN_H__
\ No newline at end of file
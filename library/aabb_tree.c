@@ -0,0 +1,335 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+#include "aabb_tree.h"
+#include "list.h"
+#include "vector.h"
+
+const size_t AABB_TREE_NULL_NODE = SIZE_MAX;
+const size_t AABB_TREE_INIT_CAPACITY = 16;
+
+typedef struct aabb_node {
+    vector_t min;
+    vector_t max;
+    // NULL for internal nodes
+    void *item;
+    // For free nodes, the next free node instead
+    size_t parent;
+    size_t left;
+    size_t right;
+    // 0 for leaves, -1 for free nodes
+    int height;
+} aabb_node_t;
+
+typedef struct aabb_tree {
+    aabb_node_t *nodes;
+    size_t capacity;
+    size_t root;
+    size_t free_list;
+    size_t size;
+    double margin;
+} aabb_tree_t;
+
+/**
+ * Threads nodes [start, capacity) onto the free list.
+ */
+void aabb_tree_link_free(aabb_tree_t *tree, size_t start) {
+    for (size_t i = start; i < tree->capacity; i++) {
+        tree->nodes[i].height = -1;
+        tree->nodes[i].parent = i + 1 < tree->capacity ? i + 1 : AABB_TREE_NULL_NODE;
+    }
+    tree->free_list = start;
+}
+
+aabb_tree_t *aabb_tree_init(double margin) {
+    assert(margin >= 0);
+    aabb_tree_t *tree = malloc(sizeof(aabb_tree_t));
+    assert(tree != NULL);
+    tree->capacity = AABB_TREE_INIT_CAPACITY;
+    tree->nodes = malloc(sizeof(aabb_node_t) * tree->capacity);
+    assert(tree->nodes != NULL);
+    aabb_tree_link_free(tree, 0);
+    tree->root = AABB_TREE_NULL_NODE;
+    tree->size = 0;
+    tree->margin = margin;
+    return tree;
+}
+
+void aabb_tree_free(aabb_tree_t *tree) {
+    free(tree->nodes);
+    free(tree);
+}
+
+void aabb_tree_clear(aabb_tree_t *tree) {
+    aabb_tree_link_free(tree, 0);
+    tree->root = AABB_TREE_NULL_NODE;
+    tree->size = 0;
+}
+
+size_t aabb_tree_size(aabb_tree_t *tree) {
+    return tree->size;
+}
+
+size_t allocate_node(aabb_tree_t *tree) {
+    if (tree->free_list == AABB_TREE_NULL_NODE) {
+        size_t old_capacity = tree->capacity;
+        tree->capacity *= 2;
+        tree->nodes = realloc(tree->nodes, sizeof(aabb_node_t) * tree->capacity);
+        assert(tree->nodes != NULL);
+        aabb_tree_link_free(tree, old_capacity);
+    }
+    size_t id = tree->free_list;
+    aabb_node_t *node = &tree->nodes[id];
+    tree->free_list = node->parent;
+    node->item = NULL;
+    node->parent = AABB_TREE_NULL_NODE;
+    node->left = AABB_TREE_NULL_NODE;
+    node->right = AABB_TREE_NULL_NODE;
+    node->height = 0;
+    return id;
+}
+
+void release_node(aabb_tree_t *tree, size_t id) {
+    tree->nodes[id].height = -1;
+    tree->nodes[id].parent = tree->free_list;
+    tree->free_list = id;
+}
+
+bool box_overlaps(vector_t min1, vector_t max1, vector_t min2, vector_t max2) {
+    return min1.x <= max2.x && min2.x <= max1.x && min1.y <= max2.y && min2.y <= max1.y;
+}
+
+bool box_contains(vector_t outer_min, vector_t outer_max, vector_t min, vector_t max) {
+    return outer_min.x <= min.x && outer_min.y <= min.y && max.x <= outer_max.x && max.y <= outer_max.y;
+}
+
+// Half the perimeter of the union of two boxes; the cost used to pick siblings
+double union_cost(vector_t min1, vector_t max1, vector_t min2, vector_t max2) {
+    return fmax(max1.x, max2.x) - fmin(min1.x, min2.x) + fmax(max1.y, max2.y) - fmin(min1.y, min2.y);
+}
+
+int max_int(int a, int b) {
+    return a > b ? a : b;
+}
+
+/**
+ * Recomputes an internal node's box and height from its children.
+ */
+void refit_node(aabb_tree_t *tree, size_t id) {
+    aabb_node_t *node = &tree->nodes[id];
+    aabb_node_t *left = &tree->nodes[node->left];
+    aabb_node_t *right = &tree->nodes[node->right];
+    node->min = (vector_t) {fmin(left->min.x, right->min.x), fmin(left->min.y, right->min.y)};
+    node->max = (vector_t) {fmax(left->max.x, right->max.x), fmax(left->max.y, right->max.y)};
+    node->height = 1 + max_int(left->height, right->height);
+}
+
+/**
+ * Replaces one child of a node's parent (or the root) with another node.
+ */
+void replace_child(aabb_tree_t *tree, size_t parent, size_t old_child, size_t new_child) {
+    tree->nodes[new_child].parent = parent;
+    if (parent == AABB_TREE_NULL_NODE) {
+        tree->root = new_child;
+    }
+    else if (tree->nodes[parent].left == old_child) {
+        tree->nodes[parent].left = new_child;
+    }
+    else {
+        tree->nodes[parent].right = new_child;
+    }
+}
+
+/**
+ * Promotes the taller grandchild of an unbalanced node to take its place.
+ * Returns the node now at the top of the subtree.
+ */
+size_t balance_node(aabb_tree_t *tree, size_t a) {
+    aabb_node_t *node_a = &tree->nodes[a];
+    if (node_a->item != NULL || node_a->height < 2) {
+        return a;
+    }
+    size_t b = node_a->left;
+    size_t c = node_a->right;
+    int balance = tree->nodes[c].height - tree->nodes[b].height;
+    if (balance > 1 || balance < -1) {
+        // Rotate the taller child (c) up, above a
+        if (balance < -1) {
+            size_t tmp = b;
+            b = c;
+            c = tmp;
+        }
+        aabb_node_t *node_c = &tree->nodes[c];
+        size_t f = node_c->left;
+        size_t g = node_c->right;
+        replace_child(tree, node_a->parent, a, c);
+        node_c->left = a;
+        node_a->parent = c;
+        // The taller grandchild stays under c, the other moves under a
+        if (tree->nodes[f].height < tree->nodes[g].height) {
+            size_t tmp = f;
+            f = g;
+            g = tmp;
+        }
+        node_c->right = f;
+        node_a->left = b;
+        node_a->right = g;
+        tree->nodes[g].parent = a;
+        refit_node(tree, a);
+        refit_node(tree, c);
+        return c;
+    }
+    return a;
+}
+
+/**
+ * Refits and rebalances every ancestor of a node, from the node up.
+ */
+void refit_ancestors(aabb_tree_t *tree, size_t id) {
+    while (id != AABB_TREE_NULL_NODE) {
+        id = balance_node(tree, id);
+        refit_node(tree, id);
+        id = tree->nodes[id].parent;
+    }
+}
+
+void insert_leaf(aabb_tree_t *tree, size_t leaf) {
+    if (tree->root == AABB_TREE_NULL_NODE) {
+        tree->root = leaf;
+        tree->nodes[leaf].parent = AABB_TREE_NULL_NODE;
+        return;
+    }
+
+    // Descend towards the sibling whose box grows the least
+    vector_t min = tree->nodes[leaf].min;
+    vector_t max = tree->nodes[leaf].max;
+    size_t sibling = tree->root;
+    while (tree->nodes[sibling].item == NULL) {
+        aabb_node_t *node = &tree->nodes[sibling];
+        aabb_node_t *left = &tree->nodes[node->left];
+        aabb_node_t *right = &tree->nodes[node->right];
+        double cost_left = union_cost(min, max, left->min, left->max);
+        double cost_right = union_cost(min, max, right->min, right->max);
+        sibling = cost_left <= cost_right ? node->left : node->right;
+    }
+
+    size_t old_parent = tree->nodes[sibling].parent;
+    size_t new_parent = allocate_node(tree);
+    replace_child(tree, old_parent, sibling, new_parent);
+    tree->nodes[new_parent].left = sibling;
+    tree->nodes[new_parent].right = leaf;
+    tree->nodes[sibling].parent = new_parent;
+    tree->nodes[leaf].parent = new_parent;
+    refit_ancestors(tree, new_parent);
+}
+
+void remove_leaf(aabb_tree_t *tree, size_t leaf) {
+    if (leaf == tree->root) {
+        tree->root = AABB_TREE_NULL_NODE;
+        return;
+    }
+    // The leaf's sibling takes the place of their parent
+    size_t parent = tree->nodes[leaf].parent;
+    size_t grandparent = tree->nodes[parent].parent;
+    size_t sibling = tree->nodes[parent].left == leaf ? tree->nodes[parent].right : tree->nodes[parent].left;
+    replace_child(tree, grandparent, parent, sibling);
+    release_node(tree, parent);
+    refit_ancestors(tree, grandparent);
+}
+
+void set_fat_box(aabb_tree_t *tree, size_t id, vector_t min, vector_t max) {
+    vector_t margin = {.x = tree->margin, .y = tree->margin};
+    tree->nodes[id].min = vec_subtract(min, margin);
+    tree->nodes[id].max = vec_add(max, margin);
+}
+
+size_t aabb_tree_insert(aabb_tree_t *tree, void *item, vector_t min, vector_t max) {
+    assert(item != NULL);
+    size_t leaf = allocate_node(tree);
+    tree->nodes[leaf].item = item;
+    set_fat_box(tree, leaf, min, max);
+    insert_leaf(tree, leaf);
+    tree->size++;
+    return leaf;
+}
+
+void aabb_tree_remove(aabb_tree_t *tree, size_t id) {
+    assert(id < tree->capacity && tree->nodes[id].item != NULL && tree->nodes[id].height == 0);
+    remove_leaf(tree, id);
+    release_node(tree, id);
+    tree->size--;
+}
+
+bool aabb_tree_move(aabb_tree_t *tree, size_t id, vector_t min, vector_t max) {
+    assert(id < tree->capacity && tree->nodes[id].item != NULL && tree->nodes[id].height == 0);
+    if (box_contains(tree->nodes[id].min, tree->nodes[id].max, min, max)) {
+        return false;
+    }
+    remove_leaf(tree, id);
+    set_fat_box(tree, id, min, max);
+    insert_leaf(tree, id);
+    return true;
+}
+
+void query_node(aabb_tree_t *tree, size_t id, vector_t min, vector_t max, list_t *results) {
+    aabb_node_t *node = &tree->nodes[id];
+    if (!box_overlaps(node->min, node->max, min, max)) {
+        return;
+    }
+    if (node->item != NULL) {
+        list_add(results, node->item);
+        return;
+    }
+    query_node(tree, node->left, min, max, results);
+    query_node(tree, node->right, min, max, results);
+}
+
+void aabb_tree_query(aabb_tree_t *tree, vector_t min, vector_t max, list_t *results) {
+    if (tree->root != AABB_TREE_NULL_NODE) {
+        query_node(tree, tree->root, min, max, results);
+    }
+}
+
+/**
+ * Reports the overlapping pairs with one item under node a and one under node b.
+ */
+void query_cross(aabb_tree_t *tree, size_t a, size_t b, aabb_pair_handler_t handler, void *aux) {
+    aabb_node_t *node_a = &tree->nodes[a];
+    aabb_node_t *node_b = &tree->nodes[b];
+    if (!box_overlaps(node_a->min, node_a->max, node_b->min, node_b->max)) {
+        return;
+    }
+    if (node_a->item != NULL && node_b->item != NULL) {
+        handler(node_a->item, node_b->item, aux);
+    }
+    // Split the taller subtree, so both sides shrink at the same rate
+    else if (node_b->item != NULL || (node_a->item == NULL && node_a->height >= node_b->height)) {
+        query_cross(tree, node_a->left, b, handler, aux);
+        query_cross(tree, node_a->right, b, handler, aux);
+    }
+    else {
+        query_cross(tree, a, node_b->left, handler, aux);
+        query_cross(tree, a, node_b->right, handler, aux);
+    }
+}
+
+/**
+ * Reports the overlapping pairs with both items under a node.
+ */
+void query_pairs_under(aabb_tree_t *tree, size_t id, aabb_pair_handler_t handler, void *aux) {
+    aabb_node_t *node = &tree->nodes[id];
+    if (node->item != NULL) {
+        return;
+    }
+    query_pairs_under(tree, node->left, handler, aux);
+    query_pairs_under(tree, node->right, handler, aux);
+    query_cross(tree, node->left, node->right, handler, aux);
+}
+
+void aabb_tree_query_pairs(aabb_tree_t *tree, aabb_pair_handler_t handler, void *aux) {
+    if (tree->root != AABB_TREE_NULL_NODE) {
+        query_pairs_under(tree, tree->root, handler, aux);
+    }
+}
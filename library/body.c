@@ -3,23 +3,40 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <math.h>
 #include <SDL2/SDL_image.h>
 #include "body.h"
 #include "color.h"
 #include "list.h"
 #include "vector.h"
 #include "polygon.h"
+#include "sdl_wrapper.h"
 
 typedef struct body_t {
-    list_t *shape;
+    // The shape relative to the centroid, before rotation; never modified
+    polygon_t *local_shape;
+    // The shape in world coordinates, recomputed from local_shape when dirty
+    polygon_t *world_shape;
+    bool world_dirty;
+    // The bounding box of world_shape, updated with it
+    vector_t bounds_min;
+    vector_t bounds_max;
+    // local_shape split into triangles, as indices into its vertices;
+    // NULL until first needed. Valid for the world shape too, since moving
+    // and rotating do not change which vertices form each triangle.
+    size_t *triangles;
     double mass;
     rgb_color_t color;
     SDL_Surface *surface;
     SDL_Texture *texture;
     vector_t centroid;
+    // The centroid before the latest body_tick(), for drawing in between ticks
+    vector_t previous_centroid;
     vector_t velocity;
     double orientation;
     double bounding_radius;
+    // Radius of the circle collider centered at the centroid; 0 if the shape is used
+    double circle_radius;
     list_t *anchors;
     bool collided;
 
@@ -30,12 +47,12 @@ typedef struct body_t {
     bool remove;
 } body_t;
 
-body_t *body_init(list_t *shape, double mass, rgb_color_t color) {
+body_t *body_init(polygon_t *shape, double mass, rgb_color_t color) {
     return body_init_with_info(shape, mass, color, NULL, NULL);
 }
 
 body_t *body_init_with_info(
-    list_t *shape,
+    polygon_t *shape,
     double mass,
     rgb_color_t color,
     void *info,
@@ -44,7 +61,12 @@ body_t *body_init_with_info(
     assert(mass >= 0);
     body_t *object = malloc(sizeof(body_t));
     assert(object != NULL);
-    object->shape = shape;
+    // The centroid starts at the origin, so the shape is already in local space
+    object->local_shape = shape;
+    object->world_shape = polygon_copy(shape);
+    object->world_dirty = false;
+    polygon_bounds(shape, &object->bounds_min, &object->bounds_max);
+    object->triangles = NULL;
     object->mass = mass;
     object->color = color;
     object->surface = NULL;
@@ -55,14 +77,16 @@ body_t *body_init_with_info(
     object->collided = false;
 
     double max_radius = 0;
-    for(size_t i = 0; i < list_size(shape); i++) {
-        vector_t *vertex = list_get(shape, i);
-        double r = vec_norm(*vertex);
+    const vector_t *vertices = polygon_vertices(shape);
+    for(size_t i = 0; i < polygon_size(shape); i++) {
+        double r = vec_norm(vertices[i]);
         if (r > max_radius) max_radius = r;
     }
     object->bounding_radius = max_radius;
+    object->circle_radius = 0;
 
     object->centroid = VEC_ZERO;
+    object->previous_centroid = VEC_ZERO;
     object->velocity = VEC_ZERO;
     object->orientation = (double) 0.0;
     object->remove = false;
@@ -77,20 +101,45 @@ void body_free(body_t *body) {
     if (body == NULL){
         return;
     }
-    list_free(body->shape);
+    polygon_free(body->local_shape);
+    polygon_free(body->world_shape);
+    free(body->triangles);
+    sdl_free_texture(body->texture);
     free(body->info);
-    free(body->anchors);
+    if (body->anchors != NULL) {
+        list_free(body->anchors);
+    }
     free(body);
 }
 
-list_t *body_get_shape(body_t *body) {
-    list_t *shape_cpy = list_init(10, NULL);
-    for(size_t i = 0; i < list_size(body->shape); i++) {
-        vector_t *temp = malloc(sizeof(vector_t));
-        *temp = *(vector_t*) list_get(body->shape, i);
-        list_add(shape_cpy, temp);
+polygon_t *body_get_shape(body_t *body) {
+    return polygon_copy(body_get_shape_view(body));
+}
+
+const polygon_t *body_get_shape_view(body_t *body) {
+    if (body->world_dirty) {
+        polygon_transform(body->world_shape, body->local_shape, body->orientation, body->centroid);
+        polygon_bounds(body->world_shape, &body->bounds_min, &body->bounds_max);
+        body->world_dirty = false;
     }
-    return shape_cpy;
+    return body->world_shape;
+}
+
+void body_get_bounds(body_t *body, vector_t *min, vector_t *max) {
+    // Brings the box up to date along with the world shape
+    body_get_shape_view(body);
+    *min = body->bounds_min;
+    *max = body->bounds_max;
+}
+
+const size_t *body_get_triangles(body_t *body) {
+    if (body->triangles == NULL) {
+        size_t size = polygon_size(body->local_shape);
+        body->triangles = malloc(sizeof(size_t) * 3 * (size - 2));
+        assert(body->triangles != NULL);
+        polygon_triangulate(body->local_shape, body->triangles);
+    }
+    return body->triangles;
 }
 
 bool body_collided(body_t *body) {
@@ -105,6 +154,10 @@ vector_t body_get_centroid(body_t *body) {
     return body->centroid;
 }
 
+vector_t body_get_previous_centroid(body_t *body) {
+    return body->previous_centroid;
+}
+
 vector_t body_get_velocity(body_t *body) {
     return body->velocity;
 }
@@ -117,10 +170,20 @@ double body_get_bounding_radius(body_t *body) {
     return body->bounding_radius;
 }
 
+void body_set_circle(body_t *body, double radius) {
+    assert(radius > 0);
+    body->circle_radius = radius;
+    body->bounding_radius = fmax(body->bounding_radius, radius);
+}
+
+double body_get_circle_radius(body_t *body) {
+    return body->circle_radius;
+}
+
 void body_translate(body_t *body, vector_t v)
 {
     body->centroid = vec_add(v, body->centroid);
-    polygon_translate(body->shape, v);
+    body->world_dirty = true;
 }
 
 rgb_color_t body_get_color(body_t *body) {
@@ -150,8 +213,10 @@ void body_set_collided(body_t *body, bool c) {
 void body_set_centroid(body_t *body, vector_t x) {
     vector_t cur_centroid = body->centroid;
     vector_t displacement = vec_subtract(x, cur_centroid);
-    polygon_translate(body->shape, displacement);
     body->centroid = x;
+    // Jumps, e.g. through a portal, should not be drawn as motion
+    body->previous_centroid = x;
+    body->world_dirty = true;
 
     if (body->anchors != NULL) {
         for (size_t i = 0; i < list_size(body->anchors); i++) {
@@ -166,15 +231,41 @@ void body_set_velocity(body_t *body, vector_t v) {
 }
 
 void body_set_rotation(body_t *body, double angle) {
-    polygon_rotate(body->shape, -1 * (body->orientation), body->centroid);
-    polygon_rotate(body->shape, angle, body->centroid);
     body->orientation = angle;
+    body->world_dirty = true;
 }
 
 double body_get_rotation(body_t *body) {
     return body->orientation;
 }
 
+body_state_t body_get_state(body_t *body) {
+    return (body_state_t) {
+        .centroid = body->centroid,
+        .previous_centroid = body->previous_centroid,
+        .velocity = body->velocity,
+        .orientation = body->orientation,
+        .remove = body->remove
+    };
+}
+
+void body_set_state(body_t *body, body_state_t state) {
+    vector_t displacement = vec_subtract(state.centroid, body->centroid);
+    if (body->anchors != NULL && (displacement.x != 0 || displacement.y != 0)) {
+        for (size_t i = 0; i < list_size(body->anchors); i++) {
+            body_translate(list_get(body->anchors, i), displacement);
+        }
+    }
+    body->centroid = state.centroid;
+    body->previous_centroid = state.previous_centroid;
+    body->velocity = state.velocity;
+    body->orientation = state.orientation;
+    body->remove = state.remove;
+    body->world_dirty = true;
+    body->force = VEC_ZERO;
+    body->impulse = VEC_ZERO;
+}
+
 void body_add_force(body_t *body, vector_t force) { 
     body->force = vec_add(body->force, force);
 }
@@ -185,7 +276,8 @@ void body_add_impulse(body_t *body, vector_t impulse) {
 
 void body_add_anchor(body_t *main_body, body_t *anchored_body) {
     if (main_body->anchors == NULL) {
-        main_body->anchors = list_init(1, (free_func_t) body_free);
+        // The anchored bodies are owned by the scene they are added to
+        main_body->anchors = list_init(1, NULL);
     }
     list_add(main_body->anchors, anchored_body);
 }
@@ -207,10 +299,12 @@ void body_set_surface(body_t *body, SDL_Surface *surf) {
 }
 
 void body_set_texture(body_t *body, SDL_Texture *tex) {
+    sdl_free_texture(body->texture);
     body->texture = tex;
 }
 
 void body_tick(body_t *body, double dt) {
+    body->previous_centroid = body->centroid;
     vector_t acceleration = vec_multiply((1.0 / body->mass), body->force);
 
     vector_t dv = vec_multiply((1.0 / body->mass), body->impulse);
@@ -221,11 +315,14 @@ void body_tick(body_t *body, double dt) {
     body_set_velocity(body, new_v);
 
     vector_t dx = vec_multiply(dt, avg_v);
-    body_translate(body, dx);
-
-    if(body->anchors != NULL) {
-        for(size_t i = 0; i < list_size(body->anchors); i++) {
-            body_translate(list_get(body->anchors, i), dx);
+    // Bodies at rest keep their cached world vertices
+    if (dx.x != 0 || dx.y != 0) {
+        body_translate(body, dx);
+
+        if(body->anchors != NULL) {
+            for(size_t i = 0; i < list_size(body->anchors); i++) {
+                body_translate(list_get(body->anchors, i), dx);
+            }
         }
     }
 
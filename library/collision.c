@@ -3,7 +3,6 @@
 #include <stdlib.h>
 #include <math.h>
 #include <limits.h>
-#include "list.h"
 #include "collision.h"
 #include "vector.h"
 #include "polygon.h"
@@ -14,28 +13,16 @@ double min(double a, double b) {
     return b;
 }
 
-list_t *orthogonal_edges_of(list_t *shape) {
-    size_t shape_size = list_size(shape);
-    list_t *edges = list_init(shape_size - 1, (free_func_t) free);
-    for(size_t i = 0; i < shape_size; i++) {
-        vector_t *p1 = list_get(shape, (i + 1) % shape_size);
-        vector_t *p2 = list_get(shape, i);
-        vector_t *edge = malloc(sizeof(vector_t));
-        // Get orthogonal transformation of edge
-        *edge = vec_orthogonal(vec_subtract(*p1, *p2));
-        list_add(edges, edge);
-    }
-    return edges;
-}
-
-collision_info_t is_separating(vector_t *axis, list_t *shape1, list_t *shape2) {
+collision_info_t is_separating(vector_t *axis, const polygon_t *shape1, const polygon_t *shape2) {
     double min_s1 = 1.0e10;
     double max_s1 = -1.0e10;
     double min_s2 = 1.0e10;
     double max_s2 = -1.0e10;
     // Update the bounds of the projection for each shape
-    for (size_t i = 0; i < list_size(shape1); i++) {
-        vector_t v = *(vector_t *) list_get(shape1, i);
+    const vector_t *vertices1 = polygon_vertices(shape1);
+    const vector_t *vertices2 = polygon_vertices(shape2);
+    for (size_t i = 0; i < polygon_size(shape1); i++) {
+        vector_t v = vertices1[i];
         // Projection of v onto the separating axis
         double p = vec_dot(v, *axis);
         if(p < min_s1) {
@@ -45,8 +32,8 @@ collision_info_t is_separating(vector_t *axis, list_t *shape1, list_t *shape2) {
             max_s1 = p;
         }
     }
-    for (size_t i = 0; i < list_size(shape2); i++) {
-        vector_t v = *(vector_t *) list_get(shape2, i);
+    for (size_t i = 0; i < polygon_size(shape2); i++) {
+        vector_t v = vertices2[i];
         // Projection of v onto the separating axis
         double p = vec_dot(v, *axis);
         if (p < min_s2) {
@@ -69,41 +56,98 @@ collision_info_t is_separating(vector_t *axis, list_t *shape1, list_t *shape2) {
     return res;
 }
 
-collision_info_t find_collision(list_t *shape1, list_t *shape2) {
+collision_info_t find_collision(const polygon_t *shape1, const polygon_t *shape2) {
     collision_info_t res;
-    list_t *push_vectors = list_init(5, (free_func_t) free);
-    list_t *all_orthogonal_edges = list_init(5, (free_func_t) free);
-    list_t *shape1_edges = orthogonal_edges_of(shape1);
-    list_t *shape2_edges = orthogonal_edges_of(shape2);
-    list_append(all_orthogonal_edges, shape1_edges);
-    list_append(all_orthogonal_edges, shape2_edges);
-    for (size_t i = 0; i < list_size(all_orthogonal_edges); i++) {
-        collision_info_t axis_result = is_separating((vector_t *) list_get(all_orthogonal_edges, i), shape1, shape2);
-        if (axis_result.collided) {
-            res.collided = false;
-            return res;
-        }
-        else {
-            vector_t *pv = malloc(sizeof(vector_t));
-            *pv = axis_result.axis;
-            list_add(push_vectors, pv);
-        }
-    }
-
-    // Get minimum push vector by overlap
+    // Minimum push vector by overlap, over the axes checked so far
     double min_norm = 1.0e10;
     vector_t min_vector;
-    for (size_t i = 0; i < list_size(push_vectors); i++) {
-        vector_t *cur_vec = list_get(push_vectors, i);
-        double cur_norm = vec_norm(*cur_vec);
-        if (cur_norm < min_norm) {
-            min_norm = cur_norm;
-            min_vector = *cur_vec;
+    const polygon_t *shapes[2] = {shape1, shape2};
+    for (size_t s = 0; s < 2; s++) {
+        size_t shape_size = polygon_size(shapes[s]);
+        const vector_t *vertices = polygon_vertices(shapes[s]);
+        for (size_t i = 0; i < shape_size; i++) {
+            // Orthogonal transformation of each edge
+            vector_t axis = vec_orthogonal(vec_subtract(vertices[(i + 1) % shape_size], vertices[i]));
+            collision_info_t axis_result = is_separating(&axis, shape1, shape2);
+            if (axis_result.collided) {
+                res.collided = false;
+                return res;
+            }
+            double cur_norm = vec_norm(axis_result.axis);
+            if (cur_norm < min_norm) {
+                min_norm = cur_norm;
+                min_vector = axis_result.axis;
+            }
         }
     }
-    
+
     vector_t normalized_axis = (vec_multiply(1/vec_norm(min_vector), min_vector));
     res.collided = true;
     res.axis = normalized_axis;
     return res;
-}
\ No newline at end of file
+}
+
+collision_info_t find_circle_collision(vector_t center1, double radius1, vector_t center2, double radius2) {
+    collision_info_t res;
+    vector_t between = vec_subtract(center2, center1);
+    double distance = vec_norm(between);
+    res.collided = distance <= radius1 + radius2;
+    // Concentric circles have no preferred axis, so pick one
+    res.axis = distance > 0 ? vec_multiply(1 / distance, between) : vec_init(1, 0);
+    return res;
+}
+
+collision_info_t find_circle_polygon_collision(vector_t center, double radius, const polygon_t *shape) {
+    collision_info_t res;
+    size_t shape_size = polygon_size(shape);
+    const vector_t *vertices = polygon_vertices(shape);
+    // The center is inside if it is on the same side of every edge
+    bool left_of_all = true;
+    bool right_of_all = true;
+    double min_distance = INFINITY;
+    vector_t closest = vertices[0];
+    vector_t closest_edge = VEC_ZERO;
+    for (size_t i = 0; i < shape_size; i++) {
+        vector_t p1 = vertices[i];
+        vector_t edge = vec_subtract(vertices[(i + 1) % shape_size], p1);
+        vector_t to_center = vec_subtract(center, p1);
+        double side = vec_cross(edge, to_center);
+        if (side < 0) left_of_all = false;
+        if (side > 0) right_of_all = false;
+
+        // Closest point to the center on this edge
+        double length_squared = vec_dot(edge, edge);
+        double t = length_squared > 0 ? vec_dot(to_center, edge) / length_squared : 0;
+        if (t < 0) t = 0;
+        if (t > 1) t = 1;
+        vector_t point = vec_add(p1, vec_multiply(t, edge));
+        double distance = vec_norm(vec_subtract(center, point));
+        if (distance < min_distance) {
+            min_distance = distance;
+            closest = point;
+            closest_edge = edge;
+        }
+    }
+
+    bool inside = left_of_all || right_of_all;
+    if (!inside && min_distance > radius) {
+        res.collided = false;
+        return res;
+    }
+    res.collided = true;
+    if (min_distance > 0) {
+        // From the center to the boundary points out of the polygon when inside
+        vector_t to_closest = vec_multiply(1 / min_distance, vec_subtract(closest, center));
+        res.axis = inside ? vec_negate(to_closest) : to_closest;
+    }
+    else {
+        // The center is on the boundary, so use that edge's normal.
+        // vec_orthogonal() turns left, which is into the polygon
+        // only if its vertices are counterclockwise.
+        res.axis = vec_normalize(vec_orthogonal(closest_edge));
+        if (signed_polygon_area(shape) < 0) {
+            res.axis = vec_negate(res.axis);
+        }
+    }
+    return res;
+}
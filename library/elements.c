@@ -13,7 +13,7 @@
 const rgb_color_t FLAG_COLOR = (rgb_color_t) {1.0, 0.549, 0.0};
 
 list_t *create_golf_ball(double radius, rgb_color_t color, double mass, vector_t location) {
-    list_t *golf_ball = list_init(1, (free_func_t) body_free);
+    list_t *golf_ball = list_init(1, NULL);
     body_t *ball = create_circle(radius, mass);
     SDL_Texture *ball_tex = sdl_load_texture("../resources/pixel_ball.png");
     body_set_texture(ball, ball_tex);
@@ -27,7 +27,7 @@ list_t *create_golf_ball(double radius, rgb_color_t color, double mass, vector_t
 }
 
 list_t *create_golf_hole(double radius, rgb_color_t color, double mass) {
-    list_t *golf_hole = list_init(3, (free_func_t) body_free);
+    list_t *golf_hole = list_init(3, NULL);
 
     body_t *hole = create_circle(radius, mass);
     SDL_Texture *hole_tex = sdl_load_texture("../resources/hole_sprite.png");
@@ -63,7 +63,7 @@ list_t *create_portals(
     vector_t coord1,
     vector_t coord2
 ) {
-    list_t *portals = list_init(2, (free_func_t) body_free);
+    list_t *portals = list_init(2, NULL);
 
     body_t *portal1 = create_circle(radius, mass);
     body_set_color(portal1, color);
@@ -91,9 +91,18 @@ spring_aux_t *spring_aux_init(double k) {
 collision_aux_t *collision_aux_init() {
     collision_aux_t *collision_bodies = malloc(sizeof(collision_aux_t));
     assert(collision_bodies != NULL);
+    collision_bodies->collided = false;
     return collision_bodies;
 }
 
+bool collision_aux_get_collided(collision_aux_t *aux) {
+    return aux->collided;
+}
+
+void collision_aux_set_collided(collision_aux_t *aux, bool collided) {
+    aux->collided = collided;
+}
+
 void newtonian_gravity_force_creator(newtonian_gravity_aux_t *aux, list_t *bodies) {
     body_t *body1 = list_get(bodies, 0);
     body_t *body2 = list_get(bodies, 1);
@@ -131,7 +140,7 @@ void drag_force_creator(drag_aux_t *aux, list_t *bodies) {
 }
 
 void create_newtonian_gravity(scene_t *scene, double G, body_t *body1, body_t *body2) {
-    list_t *bodies = list_init(2, (free_func_t)body_free);
+    list_t *bodies = list_init(2, NULL);
     list_add(bodies, body1);
     list_add(bodies, body2);
     newtonian_gravity_aux_t *newtonian_auxil = newtonian_gravity_aux_init(G);
@@ -140,7 +149,7 @@ void create_newtonian_gravity(scene_t *scene, double G, body_t *body1, body_t *b
 }
 
 void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2) {
-    list_t *bodies = list_init(2, (free_func_t)body_free);
+    list_t *bodies = list_init(2, NULL);
     list_add(bodies, body1);
     list_add(bodies, body2);
     spring_aux_t *spring_auxil = spring_aux_init(k);
@@ -148,7 +157,7 @@ void create_spring(scene_t *scene, double k, body_t *body1, body_t *body2) {
 }
 
 void create_drag(scene_t *scene, double gamma, body_t *body) {
-    list_t *bodies = list_init(1, (free_func_t)body_free);
+    list_t *bodies = list_init(1, NULL);
     list_add(bodies, body);
     drag_aux_t *drag_auxil = drag_aux_init(gamma);
     scene_add_bodies_force_creator(scene, (force_creator_t) drag_force_creator, drag_auxil, bodies, (free_func_t) free);
@@ -205,7 +214,7 @@ void create_collision(
     void *aux,
     free_func_t freer
 ) { 
-    list_t *bodies = list_init(2, (free_func_t)body_free);
+    list_t *bodies = list_init(2, NULL);
     list_add(bodies, body1);
     list_add(bodies, body2);
     collision_aux_t *col_aux = collision_aux_init();
@@ -231,6 +240,27 @@ void create_physics_collision(
     create_collision(scene, body1, body2, (collision_handler_t) physics_collision_handler, elas, free);
 }
 
+/**
+ * Finds the collision between two bodies,
+ * using the analytic tests for bodies with circle colliders.
+ */
+collision_info_t find_body_collision(body_t *body1, body_t *body2) {
+    double radius1 = body_get_circle_radius(body1);
+    double radius2 = body_get_circle_radius(body2);
+    if (radius1 > 0 && radius2 > 0) {
+        return find_circle_collision(body_get_centroid(body1), radius1, body_get_centroid(body2), radius2);
+    }
+    if (radius1 > 0) {
+        return find_circle_polygon_collision(body_get_centroid(body1), radius1, body_get_shape_view(body2));
+    }
+    if (radius2 > 0) {
+        collision_info_t info = find_circle_polygon_collision(body_get_centroid(body2), radius2, body_get_shape_view(body1));
+        info.axis = vec_negate(info.axis);
+        return info;
+    }
+    return find_collision(body_get_shape_view(body1), body_get_shape_view(body2));
+}
+
 void collision_force_creator(collision_aux_t *auxil, list_t *bodies, scene_t *scene) {
     body_t *body1 = list_get(bodies, 0);
     body_t *body2 = list_get(bodies, 1);
@@ -243,7 +273,7 @@ void collision_force_creator(collision_aux_t *auxil, list_t *bodies, scene_t *sc
         auxil->collided = false;
         return;
     }
-    collision_info_t info = find_collision(body_get_shape(body1), body_get_shape(body2));
+    collision_info_t info = find_body_collision(body1, body2);
     if(info.collided) {
         if((get_type(body2) == GRASS)) {
             if(fabs(vec_dot(body_get_velocity(body1), info.axis)) < 100) {
@@ -256,9 +286,8 @@ void collision_force_creator(collision_aux_t *auxil, list_t *bodies, scene_t *sc
             return;
         }
         else if (!auxil->collided) {
-            char *teleportsound = "../resources/teleport.wav";
             if(get_type(body2) == PORTAL) {
-                sdl_load_sound(NULL, teleportsound, 8, 5);
+                sdl_play_sound(SOUND_TELEPORT);
             }
             handler(body1, body2, info.axis, coaux);
         }
@@ -0,0 +1,391 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <sys/stat.h>
+#include "level_file.h"
+#include "cJSON.h"
+
+// The "type" strings of the JSON format, indexed by level_object_type_t
+const char *LEVEL_TYPE_NAMES[NUM_LEVEL_OBJECT_TYPES] = {
+    [LEVEL_BALL] = "BALL",
+    [LEVEL_HOLE] = "HOLE",
+    [LEVEL_GRASS] = "GRASS",
+    [LEVEL_CIRCLE_GRASS] = "CIRCLE_GRASS",
+    [LEVEL_WATER] = "WATER",
+    [LEVEL_SAND] = "SAND",
+    [LEVEL_POWER] = "POWER",
+    [LEVEL_TELEPORT] = "TELEPORT"
+};
+const char LEVEL_MAGIC[4] = {'F', 'G', 'L', 'V'};
+// Bumped whenever the layout of level_header_t or level_object_t changes
+const uint32_t LEVEL_VERSION = 1;
+// Written in the machine's byte order; reads back as this only on a machine with the same order
+const uint32_t LEVEL_BYTE_ORDER = 0x01020304;
+const char COMPILED_EXTENSION[] = ".lvl";
+const size_t INIT_VERTEX_CAPACITY = 64;
+
+/**
+ * The start of a compiled level. The object table and the vertices follow,
+ * at offsets that are multiples of 8 so they can be used in place.
+ */
+typedef struct level_header {
+    char magic[4];
+    uint32_t byte_order;
+    uint32_t version;
+    uint32_t object_count;
+    uint32_t vertex_count;
+    // Byte offsets from the start of the file
+    uint32_t objects_offset;
+    uint32_t vertices_offset;
+    uint32_t reserved;
+    vector_t bounds;
+} level_header_t;
+
+char *read_file(const char *path, size_t *length) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fileno(f), &info) != 0 || info.st_size < 0) {
+        fclose(f);
+        return NULL;
+    }
+    size_t size = info.st_size;
+    char *data = malloc(size + 1);
+    assert(data != NULL);
+    *length = fread(data, 1, size, f);
+    fclose(f);
+    if (*length != size) {
+        free(data);
+        return NULL;
+    }
+    data[size] = '\0';
+    return data;
+}
+
+bool host_is_little_endian(void) {
+    uint32_t one = 1;
+    return *(char *) &one == 1;
+}
+
+level_t *level_init(void) {
+    level_t *level = malloc(sizeof(level_t));
+    assert(level != NULL);
+    level->bounds = VEC_ZERO;
+    level->object_count = 0;
+    level->objects = NULL;
+    level->vertex_count = 0;
+    level->vertices = NULL;
+    level->data = NULL;
+    return level;
+}
+
+void level_free(level_t *level) {
+    if (level->data != NULL) {
+        free(level->data);
+    }
+    else {
+        free(level->objects);
+        free(level->vertices);
+    }
+    free(level);
+}
+
+/**
+ * Reads a numeric member of a JSON object.
+ * Prints an error and returns false if it is missing or not a number.
+ */
+bool read_number(const cJSON *json, const char *name, const char *where, double *value) {
+    const cJSON *member = cJSON_GetObjectItemCaseSensitive(json, name);
+    if (!cJSON_IsNumber(member)) {
+        fprintf(stderr, "Level error: %s has no number \"%s\"\n", where, name);
+        return false;
+    }
+    *value = member->valuedouble;
+    return true;
+}
+
+/**
+ * Reads a JSON object with numeric "x" and "y" members.
+ */
+bool read_vector(const cJSON *json, const char *where, vector_t *value) {
+    return read_number(json, "x", where, &value->x) && read_number(json, "y", where, &value->y);
+}
+
+/**
+ * Appends a JSON array of vertices to a level's vertices, recording their range.
+ * A shape needs at least 3 vertices.
+ */
+bool read_vertices(level_t *level, size_t *capacity, const cJSON *json, const char *where,
+                   uint32_t *first, uint32_t *count) {
+    if (!cJSON_IsArray(json) || cJSON_GetArraySize(json) < 3) {
+        fprintf(stderr, "Level error: %s needs an array of at least 3 vertices\n", where);
+        return false;
+    }
+    size_t size = cJSON_GetArraySize(json);
+    if (level->vertex_count + size > *capacity) {
+        *capacity = 2 * (level->vertex_count + size);
+        level->vertices = realloc(level->vertices, sizeof(vector_t) * *capacity);
+        assert(level->vertices != NULL);
+    }
+    *first = level->vertex_count;
+    *count = size;
+    const cJSON *vertex = NULL;
+    cJSON_ArrayForEach(vertex, json) {
+        if (!read_vector(vertex, where, &level->vertices[level->vertex_count])) {
+            return false;
+        }
+        level->vertex_count++;
+    }
+    return true;
+}
+
+/**
+ * Checks the radius of a LEVEL_CIRCLE_GRASS object.
+ */
+bool radius_valid(double radius) {
+    return isfinite(radius) && radius > 0;
+}
+
+level_object_type_t find_type(const char *name) {
+    for (level_object_type_t type = 0; type < NUM_LEVEL_OBJECT_TYPES; type++) {
+        if (strcmp(name, LEVEL_TYPE_NAMES[type]) == 0) {
+            return type;
+        }
+    }
+    return NUM_LEVEL_OBJECT_TYPES;
+}
+
+/**
+ * Reads one element of a level's "objects" array into an object.
+ */
+bool read_object(level_t *level, size_t *capacity, const cJSON *json, size_t index, level_object_t *object) {
+    char where[64];
+    snprintf(where, sizeof(where), "object %zu", index);
+    memset(object, 0, sizeof(*object));
+
+    const cJSON *type = cJSON_GetObjectItemCaseSensitive(json, "type");
+    if (!cJSON_IsString(type)) {
+        fprintf(stderr, "Level error: %s has no string \"type\"\n", where);
+        return false;
+    }
+    object->type = find_type(type->valuestring);
+    if (object->type == NUM_LEVEL_OBJECT_TYPES) {
+        fprintf(stderr, "Level error: %s has unknown type \"%s\"\n", where, type->valuestring);
+        return false;
+    }
+    if (!read_number(json, "pos_x", where, &object->position.x)
+            || !read_number(json, "pos_y", where, &object->position.y)) {
+        return false;
+    }
+
+    switch (object->type) {
+        case LEVEL_GRASS:
+        case LEVEL_WATER:
+        case LEVEL_SAND:
+            return read_vertices(level, capacity, cJSON_GetObjectItemCaseSensitive(json, "shape"),
+                                 where, &object->shape_first, &object->shape_count);
+        case LEVEL_TELEPORT:
+            return read_vertices(level, capacity, cJSON_GetObjectItemCaseSensitive(json, "shape"),
+                                 where, &object->shape_first, &object->shape_count)
+                && read_vertices(level, capacity, cJSON_GetObjectItemCaseSensitive(json, "out"),
+                                 where, &object->out_first, &object->out_count)
+                && read_vector(cJSON_GetObjectItemCaseSensitive(json, "direction"), where, &object->direction);
+        case LEVEL_CIRCLE_GRASS:
+            if (!read_number(json, "radius", where, &object->radius)) {
+                return false;
+            }
+            if (!radius_valid(object->radius)) {
+                fprintf(stderr, "Level error: %s has a radius that is not positive and finite\n", where);
+                return false;
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+level_t *level_parse_json(const char *json, size_t length) {
+    cJSON *root = cJSON_ParseWithLength(json, length);
+    if (root == NULL) {
+        const char *error_ptr = cJSON_GetErrorPtr();
+        if (error_ptr != NULL) {
+            fprintf(stderr, "Error before: %s\n", error_ptr);
+        }
+        return NULL;
+    }
+
+    level_t *level = level_init();
+    size_t vertex_capacity = INIT_VERTEX_CAPACITY;
+    level->vertices = malloc(sizeof(vector_t) * vertex_capacity);
+    assert(level->vertices != NULL);
+    bool valid = true;
+
+    const cJSON *bounds = cJSON_GetObjectItemCaseSensitive(root, "bounds");
+    valid = read_number(bounds, "width", "bounds", &level->bounds.x)
+        && read_number(bounds, "height", "bounds", &level->bounds.y);
+    if (valid && !(level->bounds.x > 0 && level->bounds.y > 0)) {
+        fprintf(stderr, "Level error: bounds are not positive\n");
+        valid = false;
+    }
+
+    const cJSON *objects = cJSON_GetObjectItemCaseSensitive(root, "objects");
+    if (valid && !cJSON_IsArray(objects)) {
+        fprintf(stderr, "Level error: no \"objects\" array\n");
+        valid = false;
+    }
+    if (valid) {
+        level->objects = malloc(sizeof(level_object_t) * (cJSON_GetArraySize(objects) + 1));
+        assert(level->objects != NULL);
+        const cJSON *object = NULL;
+        cJSON_ArrayForEach(object, objects) {
+            valid = read_object(level, &vertex_capacity, object, level->object_count,
+                                &level->objects[level->object_count]);
+            if (!valid) {
+                break;
+            }
+            level->object_count++;
+        }
+    }
+
+    cJSON_Delete(root);
+    if (!valid) {
+        level_free(level);
+        return NULL;
+    }
+    return level;
+}
+
+char *level_compile(const level_t *level, size_t *size) {
+    if (!host_is_little_endian()) {
+        fprintf(stderr, "Level error: compiled levels can only be written on little-endian machines\n");
+        return NULL;
+    }
+    // Both sizes are multiples of 8, so the vertices stay aligned
+    size_t objects_size = sizeof(level_object_t) * level->object_count;
+    size_t vertices_size = sizeof(vector_t) * level->vertex_count;
+    *size = sizeof(level_header_t) + objects_size + vertices_size;
+    char *data = malloc(*size);
+    assert(data != NULL);
+
+    level_header_t header = {
+        .byte_order = LEVEL_BYTE_ORDER,
+        .version = LEVEL_VERSION,
+        .object_count = level->object_count,
+        .vertex_count = level->vertex_count,
+        .objects_offset = sizeof(level_header_t),
+        .vertices_offset = sizeof(level_header_t) + objects_size,
+        .reserved = 0,
+        .bounds = level->bounds
+    };
+    memcpy(header.magic, LEVEL_MAGIC, sizeof(LEVEL_MAGIC));
+    memcpy(data, &header, sizeof(header));
+    memcpy(data + header.objects_offset, level->objects, objects_size);
+    memcpy(data + header.vertices_offset, level->vertices, vertices_size);
+    return data;
+}
+
+/**
+ * Checks that a range of vertices is empty if the object does not use it,
+ * and otherwise has at least 3 vertices, all within the level's vertices.
+ */
+bool range_valid(const level_t *level, uint32_t first, uint32_t count, bool used) {
+    if (!used) {
+        return first == 0 && count == 0;
+    }
+    return count >= 3 && first <= level->vertex_count && count <= level->vertex_count - first;
+}
+
+level_t *level_load_compiled(char *data, size_t size) {
+    level_header_t header;
+    if (size < sizeof(header)) {
+        fprintf(stderr, "Level error: compiled level is truncated\n");
+        free(data);
+        return NULL;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, LEVEL_MAGIC, sizeof(LEVEL_MAGIC)) != 0
+            || header.byte_order != LEVEL_BYTE_ORDER || header.version != LEVEL_VERSION) {
+        fprintf(stderr, "Level error: not a compiled level of this version and byte order\n");
+        free(data);
+        return NULL;
+    }
+    size_t objects_end = header.objects_offset + (size_t) header.object_count * sizeof(level_object_t);
+    size_t vertices_end = header.vertices_offset + (size_t) header.vertex_count * sizeof(vector_t);
+    if (header.objects_offset % 8 != 0 || header.vertices_offset % 8 != 0
+            || header.objects_offset < sizeof(header) || objects_end > size
+            || header.vertices_offset < sizeof(header) || vertices_end > size) {
+        fprintf(stderr, "Level error: compiled level has tables outside the file\n");
+        free(data);
+        return NULL;
+    }
+
+    // Point the level into the data instead of copying the tables out
+    level_t *level = level_init();
+    level->data = data;
+    level->bounds = header.bounds;
+    level->object_count = header.object_count;
+    level->objects = (level_object_t *) (data + header.objects_offset);
+    level->vertex_count = header.vertex_count;
+    level->vertices = (vector_t *) (data + header.vertices_offset);
+
+    for (size_t i = 0; i < level->object_count; i++) {
+        level_object_t *object = &level->objects[i];
+        bool shaped = object->type == LEVEL_GRASS || object->type == LEVEL_WATER
+            || object->type == LEVEL_SAND || object->type == LEVEL_TELEPORT;
+        bool teleport = object->type == LEVEL_TELEPORT;
+        if (object->type >= NUM_LEVEL_OBJECT_TYPES
+                || !range_valid(level, object->shape_first, object->shape_count, shaped)
+                || !range_valid(level, object->out_first, object->out_count, teleport)
+                || (object->type == LEVEL_CIRCLE_GRASS && !radius_valid(object->radius))) {
+            fprintf(stderr, "Level error: compiled level has an invalid object %zu\n", i);
+            level_free(level);
+            return NULL;
+        }
+    }
+    return level;
+}
+
+/**
+ * Gets the path of the compiled level for a JSON level:
+ * the same path with its extension replaced by COMPILED_EXTENSION.
+ */
+char *compiled_path(const char *path) {
+    const char *extension = strrchr(path, '.');
+    const char *slash = strrchr(path, '/');
+    size_t stem = extension != NULL && (slash == NULL || extension > slash)
+        ? (size_t) (extension - path)
+        : strlen(path);
+    char *result = malloc(stem + sizeof(COMPILED_EXTENSION));
+    assert(result != NULL);
+    memcpy(result, path, stem);
+    strcpy(result + stem, COMPILED_EXTENSION);
+    return result;
+}
+
+level_t *level_load(const char *path) {
+    size_t length = 0;
+    char *compiled = compiled_path(path);
+    char *data = read_file(compiled, &length);
+    free(compiled);
+    if (data != NULL) {
+        level_t *level = level_load_compiled(data, length);
+        if (level != NULL) {
+            return level;
+        }
+        fprintf(stderr, "Loading %s from JSON instead\n", path);
+    }
+
+    data = read_file(path, &length);
+    if (data == NULL) {
+        fprintf(stderr, "Level error: could not read %s\n", path);
+        return NULL;
+    }
+    level_t *level = level_parse_json(data, length);
+    free(data);
+    return level;
+}
@@ -49,6 +49,18 @@ char level_data[7][50] = {
                             "resources/level7.txt"
                         };
 
+// Every texture that terrain.c and elements.c give to level bodies
+char *LEVEL_TEXTURES[] = {
+    "../resources/pixel_ball.png",
+    "../resources/hole_sprite.png",
+    "../resources/flag_sprite.png",
+    "../resources/water_texture.png",
+    "../resources/sand_texture.png",
+    "../resources/glitter_star.png",
+    "../resources/in_portal_sprite.jpg",
+    "../resources/out_portal_sprite.png"
+};
+
 const double BALL_SIZE = 20;
 const vector_t INIT_POS1 = {.x = 50, .y = 1000};
 const double BALL_MASS = 40.0;
@@ -73,7 +85,7 @@ teleport_aux_t *make_teleport_aux(body_t *out, vector_t dir) {
 void teleport(body_t *ball, body_t *portal, vector_t axis, void *aux) {
     body_t *out = ((teleport_aux_t*) aux)->out;
     vector_t dir = ((teleport_aux_t*) aux)->direction;
-    body_set_centroid(ball, polygon_centroid(body_get_shape(out)));
+    body_set_centroid(ball, polygon_centroid(body_get_shape_view(out)));
     vector_t cur_v = body_get_velocity(ball);
     vector_t new_v = vec_multiply(-vec_norm(cur_v), dir);
     body_set_velocity(ball, new_v);
@@ -89,18 +101,15 @@ void level_end(body_t *ball, body_t *target, vector_t axis, void *aux) {
         // Win condition
         if (scene_get_level(scene) == LEVELS) {
             scene_set_state(scene, 2);
-            char *filepath = "../resources/gamewin.wav";
-            sdl_load_sound(scene, filepath, 20, 1);
+            sdl_play_sound(SOUND_GAME_WIN);
         }
         else {
             scene_set_state(scene, 1);
-            char *filepath = "../resources/levelwin.wav";
-            sdl_load_sound(scene, filepath, 30, 2);
+            sdl_play_sound(SOUND_LEVEL_WIN);
         }
     }
     if(target_info == WATER) {
-        char *filepath = "../resources/lost.wav";
-        sdl_load_sound(scene, filepath, 15, 3);
+        sdl_play_sound(SOUND_LOST);
         // Lose condition
         scene_set_state(scene, -1);
     }
@@ -114,13 +123,25 @@ void sanded(body_t *ball, body_t *target, vector_t axis, void *aux) {
 }
 
 void power_up(body_t *ball, body_t *target, vector_t axis, void *aux) {
-    scene_t *scene = aux;
     body_type_t ball_info = get_type(ball);
     assert(ball_info == BALL);
     body_set_velocity(ball, vec_multiply(2.0, body_get_velocity(ball)));
     body_remove(target);
-    char *filepath = "../resources/powerup.wav";
-    sdl_load_sound(scene, filepath, 8, 6);
+    sdl_play_sound(SOUND_POWER_UP);
+}
+
+list_t *load_level_textures(void) {
+    size_t count = sizeof(LEVEL_TEXTURES) / sizeof(LEVEL_TEXTURES[0]);
+    list_t *textures = list_init(count, (free_func_t) sdl_free_texture);
+    for (size_t i = 0; i < count; i++) {
+        list_add(textures, sdl_load_texture(LEVEL_TEXTURES[i]));
+    }
+    return textures;
+}
+
+const char *level_path(size_t level) {
+    assert(level >= 1 && level <= (size_t) LEVELS);
+    return level_data[level - 1];
 }
 
 body_t *build_level(scene_t *scene) {
@@ -141,7 +162,10 @@ body_t *build_level(scene_t *scene) {
         for(size_t i = 0; i < list_size(ball_elements); i++) {
             scene_add_body(scene, list_get(ball_elements, i));
         }
-        generate_background(scene);
+        list_free(ball_elements);
+        if (scene_background_elements(scene) == 0) {
+            generate_background(scene);
+        }
         generate_level(scene, player, level_data[level - 1]);
         scene_set_first_try(scene, false);
     } 
@@ -151,8 +175,12 @@ body_t *build_level(scene_t *scene) {
             exit(0);
         }
         player = scene_get_body(scene, 0);
-        generate_background(scene);
+        // The background is the same for every level, so it is only built once
+        if (scene_background_elements(scene) == 0) {
+            generate_background(scene);
+        }
         generate_level(scene, player, level_data[level - 1]);
     }
+    scene_index_static_bodies(scene);
     return player;
 }
\ No newline at end of file
@@ -33,6 +33,15 @@ void list_free(list_t *arr) {
     free(arr);
 }
 
+void list_clear(list_t *arr) {
+    if (arr->free_function != NULL) {
+        for (size_t i = 0; i < arr->size; i++) {
+            arr->free_function(arr->data[i]);
+        }
+    }
+    arr->size = 0;
+}
+
 size_t list_size(list_t *arr) {
     return arr->size;
 }
@@ -9,9 +9,11 @@
 body_t *collide(body_t *star, vector_t min, vector_t max, double elasticity) {
     vector_t new_v = body_get_velocity(star);
     bool collided = false;
+    const polygon_t *shape = body_get_shape_view(star);
+    const vector_t *vertices = polygon_vertices(shape);
     // Check each point to see if it crosses the border
-    for (size_t i = 0; i < list_size(body_get_shape(star)); i++) {
-        vector_t *point = list_get(body_get_shape(star), i);
+    for (size_t i = 0; i < polygon_size(shape); i++) {
+        const vector_t *point = &vertices[i];
         if (point->x > max.x) { // Crosses right
             new_v.x = fabs(body_get_velocity(star).x) * -elasticity;
             collided = true;
@@ -42,9 +44,10 @@ body_t *do_gravity(body_t *star, double gravity, double dt) {
     return star;
 }
 
-bool check_offscreen(list_t *star, vector_t min, vector_t max){
-    for(size_t i = 0; i < list_size(star); i++){
-        vector_t *point = list_get(star, i);
+bool check_offscreen(const polygon_t *star, vector_t min, vector_t max){
+    const vector_t *vertices = polygon_vertices(star);
+    for(size_t i = 0; i < polygon_size(star); i++){
+        const vector_t *point = &vertices[i];
         if(point->x < max.x && point->x > min.x && point->y < max.y && point->y > min.y){
             return false;
         }
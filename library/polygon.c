@@ -1,39 +1,105 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <assert.h>
 #include <math.h>
-#include "list.h"
+#include <stdbool.h>
+#include "polygon.h"
 #include "vector.h"
 
-double signed_polygon_area(list_t *polygon){
+typedef struct polygon {
+    size_t size;
+    size_t capacity;
+    vector_t vertices[];
+} polygon_t;
+
+polygon_t *polygon_init(size_t capacity) {
+    polygon_t *polygon = malloc(sizeof(polygon_t) + sizeof(vector_t) * capacity);
+    assert(polygon != NULL);
+    polygon->size = 0;
+    polygon->capacity = capacity;
+    return polygon;
+}
+
+void polygon_free(polygon_t *polygon) {
+    free(polygon);
+}
+
+polygon_t *polygon_copy(const polygon_t *polygon) {
+    polygon_t *copy = polygon_init(polygon->size);
+    memcpy(copy->vertices, polygon->vertices, sizeof(vector_t) * polygon->size);
+    copy->size = polygon->size;
+    return copy;
+}
+
+size_t polygon_size(const polygon_t *polygon) {
+    return polygon->size;
+}
+
+vector_t polygon_get(const polygon_t *polygon, size_t index) {
+    assert(index < polygon->size);
+    return polygon->vertices[index];
+}
+
+void polygon_set(polygon_t *polygon, size_t index, vector_t vertex) {
+    assert(index < polygon->size);
+    polygon->vertices[index] = vertex;
+}
+
+void polygon_add(polygon_t *polygon, vector_t vertex) {
+    assert(polygon->size < polygon->capacity);
+    polygon->vertices[polygon->size] = vertex;
+    polygon->size++;
+}
+
+const vector_t *polygon_vertices(const polygon_t *polygon) {
+    return polygon->vertices;
+}
+
+void polygon_bounds(const polygon_t *polygon, vector_t *min, vector_t *max) {
+    assert(polygon->size > 0);
+    vector_t lo = polygon->vertices[0];
+    vector_t hi = polygon->vertices[0];
+    for (size_t i = 1; i < polygon->size; i++) {
+        vector_t v = polygon->vertices[i];
+        if (v.x < lo.x) lo.x = v.x;
+        if (v.y < lo.y) lo.y = v.y;
+        if (v.x > hi.x) hi.x = v.x;
+        if (v.y > hi.y) hi.y = v.y;
+    }
+    *min = lo;
+    *max = hi;
+}
+
+double signed_polygon_area(const polygon_t *polygon){
     // Use formula: 1/2 |(sum_(i=1)^(n) v_i x v_(i+1))|
     double result = 0;
-    size_t size = list_size(polygon);
+    size_t size = polygon->size;
+    const vector_t *vertices = polygon->vertices;
     for(size_t i = 0; i < size; i++){
-        vector_t *i_poly = (vector_t *)list_get(polygon, i);
-        vector_t *iplusone = (vector_t *)list_get(polygon, (i+1) % size);
-        result += vec_cross(*i_poly, *iplusone);
+        result += vec_cross(vertices[i], vertices[(i+1) % size]);
     }
     return 0.5 * result;
 }
 
-double polygon_area(list_t *polygon){
+double polygon_area(const polygon_t *polygon){
     return fabs(signed_polygon_area(polygon));
 }
 
-vector_t polygon_centroid(list_t *polygon){
+vector_t polygon_centroid(const polygon_t *polygon){
     double area = signed_polygon_area(polygon);
     double x = 0;
     double y = 0;
-    size_t size = list_size(polygon);
+    size_t size = polygon->size;
+    const vector_t *vertices = polygon->vertices;
     for(size_t i = 0; i < size; i++){
-        size_t j = (i+1) % size;
-        vector_t *p_i = (vector_t*) list_get(polygon, i);
-        vector_t *p_j = (vector_t*) list_get(polygon, j);
-        double cross = vec_cross(*p_i, *p_j);
-        x += (p_i->x + p_j->x) * cross;
-        y += (p_i->y + p_j->y) * cross;
-    }
-    
+        vector_t p_i = vertices[i];
+        vector_t p_j = vertices[(i+1) % size];
+        double cross = vec_cross(p_i, p_j);
+        x += (p_i.x + p_j.x) * cross;
+        y += (p_i.y + p_j.y) * cross;
+    }
+
     x = x / (6 * area);
     y = y / (6 * area);
 
@@ -41,21 +107,142 @@ vector_t polygon_centroid(list_t *polygon){
     return result;
 }
 
-void polygon_translate(list_t *polygon, vector_t translation){
-    size_t size = list_size(polygon);
+void polygon_translate(polygon_t *polygon, vector_t translation){
+    size_t size = polygon->size;
+    vector_t *vertices = polygon->vertices;
     for(size_t i = 0; i < size; i++){
-        vector_t translated = vec_add(*(vector_t*) list_get(polygon, i), translation);
-        *(vector_t*) list_get(polygon, i) = translated;
+        vertices[i] = vec_add(vertices[i], translation);
     }
 }
 
-void polygon_rotate(list_t *polygon, double angle, vector_t point){
+void polygon_rotate(polygon_t *polygon, double angle, vector_t point){
     // Algorithm: Shift point of rotation to origin, perform rotation around origin, shift back
-    polygon_translate(polygon, vec_negate(point));
-    size_t size = list_size(polygon);
+    size_t size = polygon->size;
+    vector_t *vertices = polygon->vertices;
     for(size_t i = 0; i < size; i++){
-        vector_t rotated = vec_rotate(*(vector_t*) list_get(polygon, i), angle);
-        *(vector_t*) list_get(polygon, i) = rotated;
+        vertices[i] = vec_add(vec_rotate(vec_subtract(vertices[i], point), angle), point);
     }
-    polygon_translate(polygon, point);
-}
\ No newline at end of file
+}
+
+void polygon_transform(polygon_t *dest, const polygon_t *source, double angle, vector_t translation) {
+    assert(source->size <= dest->capacity);
+    size_t size = source->size;
+    if (angle == 0) {
+        for (size_t i = 0; i < size; i++) {
+            dest->vertices[i] = vec_add(source->vertices[i], translation);
+        }
+    }
+    else {
+        for (size_t i = 0; i < size; i++) {
+            dest->vertices[i] = vec_add(vec_rotate(source->vertices[i], angle), translation);
+        }
+    }
+    dest->size = size;
+}
+
+/**
+ * Checks whether a point is inside a triangle or on its edges.
+ * The triangle may be listed in either direction.
+ */
+bool point_in_triangle(vector_t point, vector_t a, vector_t b, vector_t c) {
+    double ab = vec_cross(vec_subtract(b, a), vec_subtract(point, a));
+    double bc = vec_cross(vec_subtract(c, b), vec_subtract(point, b));
+    double ca = vec_cross(vec_subtract(a, c), vec_subtract(point, c));
+    bool has_negative = ab < 0 || bc < 0 || ca < 0;
+    bool has_positive = ab > 0 || bc > 0 || ca > 0;
+    return !(has_negative && has_positive);
+}
+
+/**
+ * Checks whether the corner at remaining[i] can be clipped off:
+ * it turns the same way as the polygon, and no other remaining vertex
+ * is inside the triangle it forms with its neighbours.
+ */
+bool is_ear(const vector_t *vertices, const size_t *remaining, size_t count, size_t i, double direction) {
+    vector_t prev = vertices[remaining[(i + count - 1) % count]];
+    vector_t cur = vertices[remaining[i]];
+    vector_t next = vertices[remaining[(i + 1) % count]];
+    if (direction * vec_cross(vec_subtract(cur, prev), vec_subtract(next, cur)) <= 0) {
+        return false;
+    }
+    for (size_t j = 0; j < count; j++) {
+        vector_t other = vertices[remaining[j]];
+        if (j == i || j == (i + 1) % count || j == (i + count - 1) % count
+                || vec_equals(other, prev) || vec_equals(other, cur) || vec_equals(other, next)) {
+            continue;
+        }
+        if (point_in_triangle(other, prev, cur, next)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Checks whether every corner of a polygon turns the same way as the polygon
+ * (or goes straight), i.e. whether it is convex.
+ */
+bool is_convex(const vector_t *vertices, size_t size, double direction) {
+    for (size_t i = 0; i < size; i++) {
+        vector_t prev = vertices[(i + size - 1) % size];
+        vector_t cur = vertices[i];
+        vector_t next = vertices[(i + 1) % size];
+        if (direction * vec_cross(vec_subtract(cur, prev), vec_subtract(next, cur)) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t polygon_triangulate(const polygon_t *polygon, size_t *triangles) {
+    size_t size = polygon->size;
+    assert(size >= 3);
+    const vector_t *vertices = polygon->vertices;
+    double direction = signed_polygon_area(polygon) < 0 ? -1 : 1;
+
+    // A convex polygon is a fan around any vertex, found in linear time;
+    // ear clipping would take quadratic time on shapes like the circles
+    if (is_convex(vertices, size, direction)) {
+        for (size_t i = 1; i + 1 < size; i++) {
+            triangles[3 * (i - 1)] = 0;
+            triangles[3 * (i - 1) + 1] = i;
+            triangles[3 * (i - 1) + 2] = i + 1;
+        }
+        return size - 2;
+    }
+
+    // The indices of the vertices not yet clipped off, in order
+    size_t *remaining = malloc(sizeof(size_t) * size);
+    assert(remaining != NULL);
+    for (size_t i = 0; i < size; i++) {
+        remaining[i] = i;
+    }
+
+    size_t count = size;
+    size_t written = 0;
+    size_t i = 0;
+    // Corners checked since the last clip; after a full lap without an ear
+    // (only possible for degenerate polygons), the next corner is clipped anyway
+    size_t misses = 0;
+    while (count > 3) {
+        if (misses < count && !is_ear(vertices, remaining, count, i, direction)) {
+            i = (i + 1) % count;
+            misses++;
+            continue;
+        }
+        triangles[written++] = remaining[(i + count - 1) % count];
+        triangles[written++] = remaining[i];
+        triangles[written++] = remaining[(i + 1) % count];
+        memmove(&remaining[i], &remaining[i + 1], sizeof(size_t) * (count - i - 1));
+        count--;
+        if (i == count) {
+            i = 0;
+        }
+        misses = 0;
+    }
+    triangles[written++] = remaining[0];
+    triangles[written++] = remaining[1];
+    triangles[written++] = remaining[2];
+    free(remaining);
+    return size - 2;
+}
@@ -10,11 +10,22 @@
 #include "collision.h"
 #include "level_handlers.h"
 #include "body.h"
-#include "SDL2/SDL_mixer.h"
-#include <SDL2/SDL_image.h>
+#include "polygon.h"
+#include "spatial_hash.h"
+#include "aabb_tree.h"
 
 const size_t INIT_CAPACITY = 100;
 const double PADDING = 0.05;
+// How fast each scene_layer_t scrolls relative to the camera
+const double LAYER_PARALLAX[] = {
+    [SCENE_LAYER_BACKGROUND] = 0.2,
+    [SCENE_LAYER_BODIES] = 1.0
+};
+const double BROADPHASE_CELL_SIZE = 250;
+// Slack added around query boxes so rounding never hides a touching pair
+const double BROADPHASE_MARGIN = 1.0;
+// How far a body can move before its leaf in the dynamic index is reinserted
+const double BROADPHASE_FAT_MARGIN = 20;
 
 typedef struct scene {
     list_t *bodies;
@@ -25,29 +36,100 @@ typedef struct scene {
     int state;
     bool first_try;
     vector_t bound;
-    list_t *sounds;
-    SDL_Texture *image;
+
+    // Offset from world coordinates to the coordinates the bodies are drawn at.
+    // Bodies never move with the camera, so their shapes stay put
+    // unless they move in the world.
+    vector_t camera;
+    // The camera before the latest tick, for drawing in between ticks
+    vector_t previous_camera;
+
+    // Broadphase for collisions against static terrain
+    spatial_hash_t *static_index;
+    // Bodies that are checked against static_index each tick
+    list_t *dynamic_bodies;
+    // Indexed force bundles found near a dynamic body this tick and last tick
+    list_t *broadphase_candidates;
+    list_t *broadphase_active;
+    size_t bundle_sequence;
+
+    // Broadphase for collisions against bodies that are removed during play.
+    // Holds a proxy for each dynamic body and for each force bundle
+    // whose static body was added with scene_add_removable_body().
+    aabb_tree_t *dynamic_index;
+    list_t *removable_bodies;
+    list_t *tree_proxies;
+
+    // Changed whenever bodies or force creators are added or removed,
+    // so scene_restore() can tell whether a snapshot still fits the scene
+    size_t generation;
 } scene_t;
 
+typedef struct scene_snapshot {
+    // The scene's generation when the snapshot was taken
+    size_t generation;
+    size_t size;
+    size_t points;
+    int state;
+    vector_t camera;
+    vector_t previous_camera;
+    // Followed by moving_count moving_body_t,
+    // then a bit for each collision force creator that was colliding
+    size_t moving_count;
+    size_t collision_count;
+} scene_snapshot_t;
+
+// A body that is not static, with its index in the scene
+typedef struct moving_body {
+    size_t index;
+    body_state_t state;
+} moving_body_t;
+
 typedef struct force {
     force_creator_t forcer;
     void *aux;
     list_t *bodies;
     free_func_t freer;
+    // Order the bundle was added in, so indexed bundles keep their original order
+    size_t sequence;
+    // Whether the bundle is stored in the static index instead of run every tick
+    bool indexed;
+    // If indexed, the moving body whose neighbourhood the bundle is found in
+    body_t *dynamic;
+    // If indexed in the dynamic index instead of the static one, its leaf
+    struct tree_proxy *proxy;
+    // The body or pair of bodies passed to forcer, reused every tick
+    list_t *arguments;
 } force_bundle_t;
 
+typedef struct tree_proxy {
+    // The body whose bounding box the leaf holds
+    body_t *body;
+    // NULL for the leaves of dynamic bodies
+    force_bundle_t *force_bundle;
+    size_t id;
+} tree_proxy_t;
+
 force_bundle_t *force_bundle_init(force_creator_t forcer, void *aux, list_t *bodies, free_func_t freer) {
     force_bundle_t *new_force_bundle = malloc(sizeof(force_bundle_t));
     new_force_bundle->forcer = forcer;
     new_force_bundle->aux = aux;
     new_force_bundle->bodies = bodies;
     new_force_bundle->freer = freer;
+    new_force_bundle->sequence = 0;
+    new_force_bundle->indexed = false;
+    new_force_bundle->dynamic = NULL;
+    new_force_bundle->proxy = NULL;
+    new_force_bundle->arguments = list_init(2, NULL);
     return new_force_bundle;
 }
 
 void force_bundle_free(force_bundle_t *force_bundle) {
     force_bundle->freer(force_bundle->aux);
-    free(force_bundle->bodies);
+    if (force_bundle->bodies != NULL) {
+        list_free(force_bundle->bodies);
+    }
+    list_free(force_bundle->arguments);
     free(force_bundle);
 }
 
@@ -59,6 +141,10 @@ force_creator_t get_force_bundle_forcer(force_bundle_t *force_bundle) {
     return force_bundle->forcer;
 }
 
+void *get_force_bundle_aux(force_bundle_t *force_bundle) {
+    return force_bundle->aux;
+}
+
 scene_t *scene_init(void) {
     scene_t *scene = malloc(sizeof(scene_t));
     assert(scene != NULL);
@@ -70,29 +156,37 @@ scene_t *scene_init(void) {
     scene->bound = (vector_t) {.x = 2000, .y = 1000};
     scene->level = 1;
     scene->first_try = true;
-    scene->sounds = list_init(INIT_CAPACITY, (free_func_t) sdl_free_sound);
-
-    char *filepath = "../resources/intro.wav";
-    sdl_load_sound(scene, filepath, 8, 7);
+    scene->camera = VEC_ZERO;
+    scene->previous_camera = VEC_ZERO;
+    scene->static_index = spatial_hash_init(BROADPHASE_CELL_SIZE);
+    scene->dynamic_bodies = list_init(1, NULL);
+    scene->broadphase_candidates = list_init(INIT_CAPACITY, NULL);
+    scene->broadphase_active = list_init(INIT_CAPACITY, NULL);
+    scene->bundle_sequence = 0;
+    scene->dynamic_index = aabb_tree_init(BROADPHASE_FAT_MARGIN);
+    scene->removable_bodies = list_init(INIT_CAPACITY, NULL);
+    scene->tree_proxies = list_init(INIT_CAPACITY, free);
+    scene->generation = 0;
+
+    sdl_play_sound(SOUND_INTRO);
     
     return scene;
 }
 
 void scene_free(scene_t *scene) {
     list_free(scene->bodies);
+    list_free(scene->background_elements);
     list_free(scene->force_bundles);
-    list_free(scene->sounds);
-    SDL_DestroyTexture(scene->image);
-    IMG_Quit();
-    SDL_Quit();
-    Mix_Quit();
+    spatial_hash_free(scene->static_index);
+    list_free(scene->dynamic_bodies);
+    list_free(scene->broadphase_candidates);
+    list_free(scene->broadphase_active);
+    aabb_tree_free(scene->dynamic_index);
+    list_free(scene->removable_bodies);
+    list_free(scene->tree_proxies);
     free(scene);
 }
 
-void scene_add_sound(scene_t *scene, Mix_Chunk *sound) {
-    list_add(scene->sounds, sound);
-}
-
 size_t scene_bodies(scene_t *scene) {
     return list_size(scene->bodies);
 }
@@ -133,14 +227,12 @@ vector_t scene_get_bound(scene_t *scene) {
 
 void scene_add_body(scene_t *scene, body_t *body) {
     list_add(scene->bodies, body);
+    scene->generation++;
 }
 
-void scene_set_img(scene_t *scene, SDL_Texture *img){
-    scene->image = img;
-}
-
-SDL_Texture *scene_get_img(scene_t *scene) {
-    return scene->image;
+void scene_add_removable_body(scene_t *scene, body_t *body) {
+    scene_add_body(scene, body);
+    list_add(scene->removable_bodies, body);
 }
 
 void scene_add_background_element(scene_t *scene, body_t *body) {
@@ -169,13 +261,24 @@ size_t scene_set_points(scene_t *scene, size_t point) {
 }
 
 void reset_scene(scene_t *scene) {
+    // Containers are emptied rather than reallocated, so rebuilding a level
+    // reuses their memory; the background elements are kept as they are
     body_t *player = list_remove(scene->bodies, 0);
-    list_free(scene->bodies);
-    list_free(scene->force_bundles);
-    scene->bodies = list_init(INIT_CAPACITY, (free_func_t) body_free);
+    list_clear(scene->bodies);
     list_add(scene->bodies, player);
-    scene->force_bundles = list_init(INIT_CAPACITY, (free_func_t) force_bundle_free);
+    list_clear(scene->force_bundles);
     scene->points = 0;
+
+    scene->camera = VEC_ZERO;
+    scene->previous_camera = VEC_ZERO;
+    spatial_hash_clear(scene->static_index);
+    list_clear(scene->dynamic_bodies);
+    list_clear(scene->broadphase_candidates);
+    list_clear(scene->broadphase_active);
+    aabb_tree_clear(scene->dynamic_index);
+    list_clear(scene->removable_bodies);
+    list_clear(scene->tree_proxies);
+    scene->generation++;
 }
 
 size_t scene_add_level(scene_t *scene) {
@@ -199,6 +302,7 @@ void scene_remove_body(scene_t *scene, size_t index) {
     assert(index <= list_size(scene->bodies));
     body_t *removed = list_remove(scene->bodies, index);
     body_free(removed);
+    scene->generation++;
 }
 
 void scene_add_force_creator(
@@ -218,31 +322,210 @@ void scene_add_bodies_force_creator(
     free_func_t freer
 ) {
     force_bundle_t *new_force_bundle = force_bundle_init(forcer, aux, bodies, freer);
+    new_force_bundle->sequence = scene->bundle_sequence++;
     list_add(scene->force_bundles, new_force_bundle);
+    scene->generation++;
 }
 
-void scene_tick(scene_t *scene, double dt) { // Adding the force creators
+/**
+ * Gets the bounding box of a body, grown by BROADPHASE_MARGIN on every side.
+ */
+void scene_body_bounds(scene_t *scene, body_t *body, vector_t *min, vector_t *max) {
+    vector_t margin = {.x = BROADPHASE_MARGIN, .y = BROADPHASE_MARGIN};
+    double radius = body_get_circle_radius(body);
+    if (radius > 0) {
+        // The circle sticks out slightly past the polygon drawn for it
+        vector_t extent = {.x = radius, .y = radius};
+        *min = vec_subtract(body_get_centroid(body), extent);
+        *max = vec_add(body_get_centroid(body), extent);
+    }
+    else {
+        body_get_bounds(body, min, max);
+    }
+    *min = vec_subtract(*min, margin);
+    *max = vec_add(*max, margin);
+}
+
+/**
+ * Adds a leaf holding a body's bounding box to the dynamic index.
+ */
+tree_proxy_t *scene_add_tree_proxy(scene_t *scene, body_t *body, force_bundle_t *force_bundle) {
+    tree_proxy_t *proxy = malloc(sizeof(tree_proxy_t));
+    assert(proxy != NULL);
+    proxy->body = body;
+    proxy->force_bundle = force_bundle;
+    vector_t min, max;
+    scene_body_bounds(scene, body, &min, &max);
+    proxy->id = aabb_tree_insert(scene->dynamic_index, proxy, min, max);
+    list_add(scene->tree_proxies, proxy);
+    return proxy;
+}
+
+void scene_index_static_bodies(scene_t *scene) {
     for (size_t i = 0; i < list_size(scene->force_bundles); i++) {
-        force_bundle_t *curr_force_bundle = list_get(scene->force_bundles, i);
-        force_creator_t curr_force_creator = curr_force_bundle->forcer;
-        
-        for (size_t j = 0; j < list_size(curr_force_bundle->bodies); j++) {
-            // Single Bodies
-            if(curr_force_creator == (force_creator_t) drag_force_creator) {
-                list_t *body_single = list_init(2, free);
-                list_add(body_single, list_get(curr_force_bundle->bodies, j));
-                curr_force_creator(curr_force_bundle->aux, body_single);
-            }
-            // Multiple bodies
-            else{
-                list_t *body_pair = list_init(2, free);
-                list_add(body_pair, list_get(curr_force_bundle->bodies, j));
-                list_add(body_pair, list_get(curr_force_bundle->bodies, (j+1) % list_size(curr_force_bundle->bodies)));
-                curr_force_creator(curr_force_bundle->aux, body_pair);
+        force_bundle_t *force_bundle = list_get(scene->force_bundles, i);
+        if (force_bundle->indexed ||
+            force_bundle->forcer != (force_creator_t) collision_force_creator ||
+            list_size(force_bundle->bodies) != 2) {
+            continue;
+        }
+        body_t *body1 = list_get(force_bundle->bodies, 0);
+        body_t *body2 = list_get(force_bundle->bodies, 1);
+        body_t *terrain;
+        body_t *dynamic;
+        if (body_get_mass(body1) == INFINITY && body_get_mass(body2) != INFINITY) {
+            terrain = body1;
+            dynamic = body2;
+        }
+        else if (body_get_mass(body2) == INFINITY && body_get_mass(body1) != INFINITY) {
+            terrain = body2;
+            dynamic = body1;
+        }
+        else {
+            continue;
+        }
+        if (!list_contains(scene->dynamic_bodies, dynamic)) {
+            list_add(scene->dynamic_bodies, dynamic);
+            scene_add_tree_proxy(scene, dynamic, NULL);
+        }
+        if (list_contains(scene->removable_bodies, terrain)) {
+            force_bundle->proxy = scene_add_tree_proxy(scene, terrain, force_bundle);
+        }
+        else {
+            vector_t min, max;
+            scene_body_bounds(scene, terrain, &min, &max);
+            spatial_hash_insert(scene->static_index, force_bundle, min, max);
+        }
+        force_bundle->indexed = true;
+        force_bundle->dynamic = dynamic;
+    }
+}
+
+/**
+ * Removes a leaf from the dynamic index and frees it.
+ */
+void scene_remove_tree_proxy(scene_t *scene, tree_proxy_t *proxy) {
+    aabb_tree_remove(scene->dynamic_index, proxy->id);
+    list_delete(scene->tree_proxies, proxy);
+    free(proxy);
+}
+
+/**
+ * Removes an indexed force bundle from whichever index holds it.
+ */
+void scene_unindex_force_bundle(scene_t *scene, force_bundle_t *force_bundle) {
+    if (force_bundle->proxy != NULL) {
+        scene_remove_tree_proxy(scene, force_bundle->proxy);
+        force_bundle->proxy = NULL;
+    }
+    else {
+        spatial_hash_remove(scene->static_index, force_bundle);
+    }
+    list_delete(scene->broadphase_active, force_bundle);
+}
+
+/**
+ * Adds a pair from the dynamic index to the candidates
+ * if it is a dynamic body and a force bundle acting on it.
+ */
+void scene_add_tree_pair(tree_proxy_t *proxy1, tree_proxy_t *proxy2, scene_t *scene) {
+    if (proxy1->force_bundle == NULL) {
+        tree_proxy_t *tmp = proxy1;
+        proxy1 = proxy2;
+        proxy2 = tmp;
+    }
+    if (proxy1->force_bundle != NULL && proxy2->force_bundle == NULL &&
+        proxy1->force_bundle->dynamic == proxy2->body) {
+        list_add(scene->broadphase_candidates, proxy1->force_bundle);
+    }
+}
+
+void force_bundle_apply(force_bundle_t *curr_force_bundle) {
+    force_creator_t curr_force_creator = curr_force_bundle->forcer;
+    list_t *arguments = curr_force_bundle->arguments;
+    for (size_t j = 0; j < list_size(curr_force_bundle->bodies); j++) {
+        list_clear(arguments);
+        // Single Bodies
+        if(curr_force_creator == (force_creator_t) drag_force_creator) {
+            list_add(arguments, list_get(curr_force_bundle->bodies, j));
+        }
+        // Multiple bodies
+        else{
+            list_add(arguments, list_get(curr_force_bundle->bodies, j));
+            list_add(arguments, list_get(curr_force_bundle->bodies, (j+1) % list_size(curr_force_bundle->bodies)));
+        }
+        curr_force_creator(curr_force_bundle->aux, arguments);
+    }
+}
+
+/**
+ * Runs the indexed force bundles whose terrain is near one of the dynamic bodies.
+ */
+void scene_tick_broadphase(scene_t *scene) {
+    list_t *candidates = scene->broadphase_candidates;
+    list_clear(candidates);
+    for (size_t i = 0; i < list_size(scene->tree_proxies); i++) {
+        tree_proxy_t *proxy = list_get(scene->tree_proxies, i);
+        if (proxy->force_bundle == NULL) {
+            vector_t min, max;
+            scene_body_bounds(scene, proxy->body, &min, &max);
+            aabb_tree_move(scene->dynamic_index, proxy->id, min, max);
+        }
+    }
+    aabb_tree_query_pairs(scene->dynamic_index, (aabb_pair_handler_t) scene_add_tree_pair, scene);
+
+    for (size_t i = 0; i < list_size(scene->dynamic_bodies); i++) {
+        body_t *body = list_get(scene->dynamic_bodies, i);
+        vector_t min, max;
+        scene_body_bounds(scene, body, &min, &max);
+        size_t first = list_size(candidates);
+        spatial_hash_query(scene->static_index, min, max, candidates);
+        for (size_t j = first; j < list_size(candidates); j++) {
+            force_bundle_t *force_bundle = list_get(candidates, j);
+            if (force_bundle->dynamic != body) {
+                list_remove(candidates, j);
+                j--;
             }
+        }
+    }
+
+    // Insertion sort by sequence; there are only ever a handful of candidates
+    for (size_t i = 1; i < list_size(candidates); i++) {
+        force_bundle_t *curr = list_get(candidates, i);
+        size_t j = i;
+        while (j > 0 && ((force_bundle_t *) list_get(candidates, j - 1))->sequence > curr->sequence) {
+            list_replace(candidates, j, list_get(candidates, j - 1));
+            j--;
+        }
+        list_replace(candidates, j, curr);
+    }
 
+    for (size_t i = 0; i < list_size(candidates); i++) {
+        force_bundle_apply(list_get(candidates, i));
+    }
+    // Bundles that just left the neighbourhood still need to see
+    // that their bodies are no longer colliding
+    for (size_t i = 0; i < list_size(scene->broadphase_active); i++) {
+        force_bundle_t *force_bundle = list_get(scene->broadphase_active, i);
+        if (!list_contains(candidates, force_bundle)) {
+            force_bundle_apply(force_bundle);
         }
     }
+
+    list_clear(scene->broadphase_active);
+    for (size_t i = 0; i < list_size(candidates); i++) {
+        list_add(scene->broadphase_active, list_get(candidates, i));
+    }
+}
+
+void scene_tick(scene_t *scene, double dt) { // Adding the force creators
+    for (size_t i = 0; i < list_size(scene->force_bundles); i++) {
+        force_bundle_t *curr_force_bundle = list_get(scene->force_bundles, i);
+        if (!curr_force_bundle->indexed) {
+            force_bundle_apply(curr_force_bundle);
+        }
+    }
+    scene_tick_broadphase(scene);
     body_t *ball = scene_get_body(scene, 0);
     vector_t center = vec_multiply(0.5, scene_get_bound(scene));
     vector_t ball_disp;
@@ -254,24 +537,134 @@ void scene_tick(scene_t *scene, double dt) { // Adding the force creators
                 force_bundle_t *force_bundle = list_get(scene->force_bundles, j);
                 list_t *bodies = force_bundle->bodies;
                 if (list_contains(bodies, curr_body)) {
+                    if (force_bundle->indexed) {
+                        scene_unindex_force_bundle(scene, force_bundle);
+                    }
                     force_bundle_free(list_remove(scene->force_bundles, j)); 
                     j--;
                 }
             }
-            list_remove(scene->bodies, i);
+            if (list_contains(scene->dynamic_bodies, curr_body)) {
+                list_delete(scene->dynamic_bodies, curr_body);
+                for (size_t j = 0; j < list_size(scene->tree_proxies); j++) {
+                    tree_proxy_t *proxy = list_get(scene->tree_proxies, j);
+                    if (proxy->body == curr_body && proxy->force_bundle == NULL) {
+                        scene_remove_tree_proxy(scene, proxy);
+                        break;
+                    }
+                }
+            }
+            list_delete(scene->removable_bodies, curr_body);
+            body_free(list_remove(scene->bodies, i));
+            scene->generation++;
             i--;
             continue;
         }
         body_tick(curr_body, dt);
         if (i == 0) {
-            ball_disp = vec_subtract(center, body_get_centroid(ball));
+            vector_t ball_on_screen = vec_add(body_get_centroid(ball), scene->camera);
+            ball_disp = vec_subtract(center, ball_on_screen);
         }
-        body_translate(curr_body, vec_multiply(PADDING, ball_disp));
         body_set_collided(curr_body, false);
     }
 
-    for (size_t i = 0; i < list_size(scene->background_elements); i++) {
-        body_t *curr_body = scene_get_background_element(scene, i);
-        body_translate(curr_body, vec_multiply(PADDING / 5, ball_disp)); // Parallax effect
+    // Ease the camera towards the ball
+    scene->previous_camera = scene->camera;
+    scene->camera = vec_add(scene->camera, vec_multiply(PADDING, ball_disp));
+}
+
+vector_t scene_get_view_offset(scene_t *scene, scene_layer_t layer, double alpha) {
+    vector_t camera = vec_add(scene->previous_camera,
+                              vec_multiply(alpha, vec_subtract(scene->camera, scene->previous_camera)));
+    return vec_multiply(LAYER_PARALLAX[layer], camera);
+}
+/**
+ * Whether a force bundle is a collision, whose collided flag is part of a snapshot.
+ */
+bool is_collision_bundle(force_bundle_t *force_bundle) {
+    return force_bundle->forcer == (force_creator_t) collision_force_creator;
+}
+
+scene_snapshot_t *scene_snapshot(scene_t *scene) {
+    size_t moving_count = 0;
+    for (size_t i = 0; i < list_size(scene->bodies); i++) {
+        if (body_get_mass(list_get(scene->bodies, i)) != INFINITY) {
+            moving_count++;
+        }
+    }
+    size_t collision_count = 0;
+    for (size_t i = 0; i < list_size(scene->force_bundles); i++) {
+        if (is_collision_bundle(list_get(scene->force_bundles, i))) {
+            collision_count++;
+        }
+    }
+
+    size_t size = sizeof(scene_snapshot_t) + moving_count * sizeof(moving_body_t) +
+                  (collision_count + 7) / 8;
+    scene_snapshot_t *snapshot = calloc(1, size);
+    assert(snapshot != NULL);
+    snapshot->generation = scene->generation;
+    snapshot->size = size;
+    snapshot->points = scene->points;
+    snapshot->state = scene->state;
+    snapshot->camera = scene->camera;
+    snapshot->previous_camera = scene->previous_camera;
+    snapshot->moving_count = moving_count;
+    snapshot->collision_count = collision_count;
+
+    moving_body_t *moving = (moving_body_t *) (snapshot + 1);
+    for (size_t i = 0; i < list_size(scene->bodies); i++) {
+        body_t *body = list_get(scene->bodies, i);
+        if (body_get_mass(body) != INFINITY) {
+            *moving++ = (moving_body_t) {.index = i, .state = body_get_state(body)};
+        }
     }
-}
\ No newline at end of file
+    unsigned char *collided = (unsigned char *) moving;
+    size_t bit = 0;
+    for (size_t i = 0; i < list_size(scene->force_bundles); i++) {
+        force_bundle_t *force_bundle = list_get(scene->force_bundles, i);
+        if (is_collision_bundle(force_bundle)) {
+            if (collision_aux_get_collided(force_bundle->aux)) {
+                collided[bit / 8] |= 1 << (bit % 8);
+            }
+            bit++;
+        }
+    }
+    return snapshot;
+}
+
+size_t scene_snapshot_size(const scene_snapshot_t *snapshot) {
+    return snapshot->size;
+}
+
+bool scene_restore(scene_t *scene, const scene_snapshot_t *snapshot) {
+    if (snapshot->generation != scene->generation) {
+        return false;
+    }
+    scene->points = snapshot->points;
+    scene->state = snapshot->state;
+    scene->camera = snapshot->camera;
+    scene->previous_camera = snapshot->previous_camera;
+
+    const moving_body_t *moving = (const moving_body_t *) (snapshot + 1);
+    for (size_t i = 0; i < snapshot->moving_count; i++) {
+        body_set_state(list_get(scene->bodies, moving[i].index), moving[i].state);
+    }
+    const unsigned char *collided = (const unsigned char *) (moving + snapshot->moving_count);
+    size_t bit = 0;
+    // Indexed collisions that were touching must be run again next tick,
+    // even if their bodies have moved apart, to see that they separated
+    list_clear(scene->broadphase_active);
+    for (size_t i = 0; i < list_size(scene->force_bundles); i++) {
+        force_bundle_t *force_bundle = list_get(scene->force_bundles, i);
+        if (is_collision_bundle(force_bundle)) {
+            bool was_colliding = collided[bit / 8] & (1 << (bit % 8));
+            collision_aux_set_collided(force_bundle->aux, was_colliding);
+            if (was_colliding && force_bundle->indexed) {
+                list_add(scene->broadphase_active, force_bundle);
+            }
+            bit++;
+        }
+    }
+    return true;
+}
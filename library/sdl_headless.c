@@ -0,0 +1,17 @@
+#include <stddef.h>
+#include "sdl_wrapper.h"
+
+// Stand-ins for the asset functions of sdl_wrapper.c, for programs that
+// run the game without a window or audio device (see demo/sim.c).
+// Link this instead of sdl_wrapper.o; the SDL libraries are not needed.
+// Bodies get no textures and no sounds are played.
+
+SDL_Texture *sdl_load_texture(char *filepath) {
+    return NULL;
+}
+
+void sdl_free_texture(SDL_Texture *texture) {}
+
+void sdl_play_sound(sound_t sound) {}
+
+void sdl_stop_sound(sound_t sound) {}
@@ -1,12 +1,11 @@
 #include <assert.h>
 #include <math.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_render.h>
 #include <SDL2/SDL_image.h>
-#include <SDL2/SDL2_gfxPrimitives.h>
 #include <SDL2/SDL_mixer.h>
 #include "sdl_wrapper.h"
 #include "terrain.h"
@@ -16,6 +15,33 @@ const char WINDOW_TITLE[] = "Flappy Golf";
 const int WINDOW_WIDTH = 1000;
 const int WINDOW_HEIGHT = 500;
 const double MS_PER_S = 1e3;
+const char FONT_PATH[] = "resources/gamefont.ttf";
+char MENU_IMAGE_PATH[] = "../resources/intro_img.png";
+// The most rendered strings kept at once; the least recently drawn is evicted
+const size_t TEXT_CACHE_CAPACITY = 32;
+// Glyph atlases are this many pixels wide, and as tall as their glyphs need
+const int GLYPH_ATLAS_WIDTH = 512;
+// The characters in a glyph atlas: printable ASCII
+#define GLYPH_FIRST ' '
+#define GLYPH_LAST '~'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+
+typedef struct sound_info {
+    char *filepath;
+    // Out of MIX_MAX_VOLUME
+    int volume;
+} sound_info_t;
+
+// The file and volume of each sound_t; each plays on the channel numbered by its sound_t
+const sound_info_t SOUND_INFO[NUM_SOUNDS] = {
+    [SOUND_INTRO] = {"../resources/intro.wav", 8},
+    [SOUND_FLAP] = {"../resources/popsound.wav", 50},
+    [SOUND_TELEPORT] = {"../resources/teleport.wav", 8},
+    [SOUND_POWER_UP] = {"../resources/powerup.wav", 8},
+    [SOUND_LEVEL_WIN] = {"../resources/levelwin.wav", 30},
+    [SOUND_GAME_WIN] = {"../resources/gamewin.wav", 20},
+    [SOUND_LOST] = {"../resources/lost.wav", 15}
+};
 
 /**
  * The coordinate at the center of the screen.
@@ -37,27 +63,275 @@ SDL_Renderer *renderer;
  * The keypress handler, or NULL if none has been configured.
  */
 key_handler_t key_handler = NULL;
+/**
+ * Set by sdl_request_quit(), so sdl_is_done() reports the game as closed.
+ */
+bool quit_requested = false;
 /**
  * SDL's timestamp when a key was last pressed or released.
  * Used to mesasure how long a key has been held.
  */
 uint32_t key_start_timestamp;
 /**
- * The value of clock() when time_since_last_tick() was last called.
- * Initially 0.
+ * The value of SDL_GetPerformanceCounter() when time_since_last_tick()
+ * was last called. Initially 0.
+ * Unlike clock(), which counts CPU time, this follows the wall clock.
+ */
+Uint64 last_counter = 0;
+/**
+ * Whether the audio device was opened by sdl_init().
+ */
+bool audio_open = false;
+/**
+ * The decoded sounds, indexed by sound_t. NULL for any that failed to load.
+ */
+Mix_Chunk *sound_bank[NUM_SOUNDS];
+
+/**
+ * The textures loaded by sdl_load_texture(), as texture_entry_t's.
+ * Each image file is decoded once and shared until its last user releases it.
+ */
+list_t *textures = NULL;
+
+typedef struct texture_entry {
+    char *filepath;
+    SDL_Texture *texture;
+    // The number of sdl_load_texture() calls not yet matched by sdl_free_texture()
+    size_t references;
+} texture_entry_t;
+
+void texture_entry_free(texture_entry_t *entry) {
+    SDL_DestroyTexture(entry->texture);
+    free(entry->filepath);
+    free(entry);
+}
+
+typedef struct glyph {
+    // Where the glyph is in the atlas texture
+    SDL_Rect source;
+    // How far the pen moves after drawing the glyph
+    int advance;
+} glyph_t;
+
+/**
+ * Every glyph of a font at one size, rasterized into a single texture,
+ * so any string can be drawn without rasterizing or creating textures.
+ */
+typedef struct glyph_atlas {
+    SDL_Texture *texture;
+    int width;
+    int height;
+    glyph_t glyphs[GLYPH_COUNT];
+} glyph_atlas_t;
+
+/**
+ * The fonts opened so far, one font_entry_t per size.
+ */
+list_t *fonts = NULL;
+
+typedef struct font_entry {
+    int size;
+    // NULL if the font could not be opened
+    TTF_Font *font;
+    // NULL until text of this size is first drawn with sdl_draw_text()
+    glyph_atlas_t *atlas;
+} font_entry_t;
+
+void font_entry_free(font_entry_t *entry) {
+    if (entry->font != NULL) {
+        TTF_CloseFont(entry->font);
+    }
+    if (entry->atlas != NULL) {
+        SDL_DestroyTexture(entry->atlas->texture);
+        free(entry->atlas);
+    }
+    free(entry);
+}
+
+/**
+ * The background image of the menu screens.
+ */
+SDL_Texture *menu_image = NULL;
+/**
+ * The last menu screen drawn, kept so an unchanged menu is one copy per frame.
+ */
+SDL_Texture *menu_target = NULL;
+/**
+ * Whether menu_target holds a menu; false until one is drawn,
+ * and after the renderer loses the contents of its render targets.
+ */
+bool menu_valid = false;
+
+// Everything a menu screen is drawn from
+typedef struct menu_key {
+    int state;
+    size_t points;
+    size_t level;
+    int width;
+    int height;
+} menu_key_t;
+
+/**
+ * What the menu in menu_target was drawn from.
+ */
+menu_key_t menu_key;
+
+/**
+ * The scene's background elements drawn once, with no offset.
+ * NULL if it has not been drawn, or is too large for a texture.
+ */
+SDL_Texture *background_target = NULL;
+/**
+ * Whether background_target holds the current background;
+ * false after the renderer loses the contents of its render targets.
+ */
+bool background_valid = false;
+
+// Everything the background layer is drawn from
+typedef struct background_key {
+    scene_t *scene;
+    size_t count;
+    // The elements are static, so a change of elements shows up here or in count
+    body_t *first;
+    int width;
+    int height;
+} background_key_t;
+
+/**
+ * What the layer in background_target was drawn from.
+ */
+background_key_t background_key;
+/**
+ * The top left corner of the background elements' bounding box, in world
+ * coordinates; background_target is drawn with its top left corner there.
+ */
+vector_t background_corner;
+/**
+ * The size of background_target, in pixels.
+ */
+int background_width;
+int background_height;
+
+/**
+ * What draw_snapshot() needs of one body, copied out of the scene.
+ */
+typedef struct body_snapshot {
+    // Where the body's world vertices start in the snapshot's vertices
+    size_t first_vertex;
+    size_t vertex_count;
+    // Where the body's triangles start in the snapshot's triangles;
+    // textured bodies have none
+    size_t first_index;
+    rgb_color_t color;
+    // Level textures stay loaded for the whole game, so this is never freed
+    // while a snapshot still points to it
+    SDL_Texture *texture;
+    vector_t min;
+    vector_t max;
+    // How far the body's centroid moved during the last tick
+    vector_t motion;
+} body_snapshot_t;
+
+/**
+ * Everything drawn each frame, copied out of a scene by sdl_publish_scene(),
+ * so it can be drawn while the scene keeps changing on another thread.
+ * The arrays are kept between publishes and only grown.
+ */
+typedef struct render_snapshot {
+    int state;
+    size_t points;
+    size_t level;
+    // The view offsets of each layer at the previous tick and the latest one
+    vector_t background_start;
+    vector_t background_end;
+    vector_t bodies_start;
+    vector_t bodies_end;
+    body_snapshot_t *bodies;
+    size_t body_count;
+    size_t body_capacity;
+    vector_t *vertices;
+    size_t vertex_count;
+    size_t vertex_capacity;
+    size_t *triangles;
+    size_t index_count;
+    size_t index_capacity;
+    // The value of SDL_GetPerformanceCounter() when it was published
+    Uint64 published;
+} render_snapshot_t;
+
+/**
+ * A triple buffer of snapshots: at any time one is being written by
+ * sdl_publish_scene(), one is being drawn, and the third is the latest
+ * complete one. Neither the publisher nor the drawer ever waits for the other.
+ */
+render_snapshot_t snapshots[3];
+/**
+ * The snapshot sdl_publish_scene() writes next. Only used by the publisher.
+ */
+int write_snapshot = 0;
+/**
+ * The snapshot being drawn. Only used by the thread that draws.
+ */
+int read_snapshot = 1;
+/**
+ * The remaining snapshot, with SNAPSHOT_FRESH set if it was published
+ * after read_snapshot was taken. Swapped atomically by both sides.
+ */
+SDL_atomic_t latest_snapshot = {2};
+const int SNAPSHOT_FRESH = 4;
+
+/**
+ * Untextured polygons drawn since the last flush_batch(), as triangles
+ * in window pixels, with each vertex carrying its polygon's color.
+ * Kept between frames and only grown, so batching does not allocate.
+ */
+SDL_Vertex *batch_vertices = NULL;
+size_t batch_vertex_count = 0;
+size_t batch_vertex_capacity = 0;
+int *batch_indices = NULL;
+size_t batch_index_count = 0;
+size_t batch_index_capacity = 0;
+
+/**
+ * Vertices and indices for the quads of sdl_draw_text().
+ * Kept between calls and only grown, so drawing text does not allocate.
+ */
+SDL_Vertex *text_vertices = NULL;
+int *text_indices = NULL;
+size_t text_quad_capacity = 0;
+
+/**
+ * Strings already rendered to textures, as text_entry_t's.
+ * Holds at most TEXT_CACHE_CAPACITY entries.
  */
-clock_t last_clock = 0;
+list_t *texts = NULL;
+/**
+ * Counts calls to render_text(), to find the least recently used text.
+ */
+size_t text_clock = 0;
+
+typedef struct text_entry {
+    char *message;
+    int font_size;
+    SDL_Color color;
+    SDL_Texture *texture;
+    int width;
+    int height;
+    // The value of text_clock when the text was last drawn
+    size_t last_used;
+} text_entry_t;
+
+void text_entry_free(text_entry_t *entry) {
+    SDL_DestroyTexture(entry->texture);
+    free(entry->message);
+    free(entry);
+}
 
 /** Computes the center of the window in pixel coordinates */
 vector_t get_window_center(void) {
-    int *width = malloc(sizeof(*width)),
-        *height = malloc(sizeof(*height));
-    assert(width != NULL);
-    assert(height != NULL);
-    SDL_GetWindowSize(window, width, height);
-    vector_t dimensions = {.x = *width, .y = *height};
-    free(width);
-    free(height);
+    int width, height;
+    SDL_GetWindowSize(window, &width, &height);
+    vector_t dimensions = {.x = width, .y = height};
     return vec_multiply(0.5, dimensions);
 }
 
@@ -127,113 +401,376 @@ void sdl_init(vector_t min, vector_t max) {
     );
     assert (window != NULL);
 
-    renderer = SDL_CreateRenderer(window, -1, 0);
+    // Presenting waits for the display, so idle screens do not spin the CPU
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_PRESENTVSYNC);
+    textures = list_init(1, (free_func_t) texture_entry_free);
+    menu_image = sdl_load_texture(MENU_IMAGE_PATH);
+    fonts = list_init(1, (free_func_t) font_entry_free);
+    texts = list_init(TEXT_CACHE_CAPACITY, (free_func_t) text_entry_free);
+
+    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+        printf("Unable to open sound: %s\n", Mix_GetError());
+        return;
+    }
+    audio_open = true;
+    Mix_AllocateChannels(NUM_SOUNDS);
+    for (sound_t sound = 0; sound < NUM_SOUNDS; sound++) {
+        sound_bank[sound] = Mix_LoadWAV(SOUND_INFO[sound].filepath);
+        if (sound_bank[sound] == NULL) {
+            printf("Unable to load %s: %s\n", SOUND_INFO[sound].filepath, Mix_GetError());
+            continue;
+        }
+        Mix_VolumeChunk(sound_bank[sound], SOUND_INFO[sound].volume);
+    }
 }
 
 SDL_Texture *sdl_load_texture(char *filepath) {
+    for (size_t i = 0; i < list_size(textures); i++) {
+        texture_entry_t *entry = list_get(textures, i);
+        if (strcmp(entry->filepath, filepath) == 0) {
+            entry->references++;
+            return entry->texture;
+        }
+    }
     SDL_Texture *tex = IMG_LoadTexture(renderer, filepath);
     assert (tex != NULL);
+    texture_entry_t *entry = malloc(sizeof(texture_entry_t));
+    assert(entry != NULL);
+    entry->filepath = strdup(filepath);
+    entry->texture = tex;
+    entry->references = 1;
+    list_add(textures, entry);
     return tex;
 }
 
-Mix_Chunk *sdl_load_sound(scene_t *scene, char *filepath, int volume, int channel) {
-    Mix_Chunk *sound = NULL;
-    int success = Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048);
-    if (success < 0) {
-        printf("Unable to open sound.");
+void sdl_play_sound(sound_t sound) {
+    if (audio_open && sound_bank[sound] != NULL) {
+        Mix_PlayChannel(sound, sound_bank[sound], 0);
     }
-    sound = Mix_LoadWAV(filepath);
-    Mix_VolumeChunk(sound, volume);
-    Mix_PlayChannel(channel, sound, 0);
-    return sound;
 }
 
-void sdl_free_sound(Mix_Chunk *sound) {
-    Mix_FreeChunk(sound);
+void sdl_stop_sound(sound_t sound) {
+    if (audio_open) {
+        Mix_HaltChannel(sound);
+    }
 }
 
-SDL_Texture *sdl_load_image(char *filepath){
-    SDL_Texture *img = NULL;
-    img = IMG_LoadTexture(renderer, filepath);
+void sdl_free_texture(SDL_Texture *texture) {
+    if (texture == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < list_size(textures); i++) {
+        texture_entry_t *entry = list_get(textures, i);
+        if (entry->texture == texture) {
+            entry->references--;
+            if (entry->references == 0) {
+                texture_entry_free(list_remove(textures, i));
+            }
+            return;
+        }
+    }
+    // Not from sdl_load_texture(), so nothing else shares it
+    SDL_DestroyTexture(texture);
+}
 
-    int w, h;
-    SDL_QueryTexture(img, NULL, NULL, &w, &h);
-    SDL_Rect texr; texr.x = 0; texr.y = 0; texr.w = w/2.15; texr.h = h/2.8;
-    SDL_RenderCopy(renderer, img, NULL, &texr);
+void sdl_quit(void) {
+    if (menu_target != NULL) {
+        SDL_DestroyTexture(menu_target);
+        menu_target = NULL;
+    }
+    menu_valid = false;
+    sdl_free_texture(menu_image);
+    menu_image = NULL;
+    if (background_target != NULL) {
+        SDL_DestroyTexture(background_target);
+        background_target = NULL;
+    }
+    background_valid = false;
+    for (size_t i = 0; i < 3; i++) {
+        free(snapshots[i].bodies);
+        free(snapshots[i].vertices);
+        free(snapshots[i].triangles);
+        snapshots[i] = (render_snapshot_t) {0};
+    }
+    list_free(textures);
+    textures = NULL;
+    list_free(texts);
+    texts = NULL;
+    list_free(fonts);
+    fonts = NULL;
+    free(batch_vertices);
+    free(batch_indices);
+    batch_vertices = NULL;
+    batch_indices = NULL;
+    batch_vertex_capacity = 0;
+    batch_index_capacity = 0;
+    free(text_vertices);
+    free(text_indices);
+    text_vertices = NULL;
+    text_indices = NULL;
+    text_quad_capacity = 0;
+    TTF_Quit();
+    if (audio_open) {
+        Mix_HaltChannel(-1);
+        for (sound_t sound = 0; sound < NUM_SOUNDS; sound++) {
+            Mix_FreeChunk(sound_bank[sound]);
+            sound_bank[sound] = NULL;
+        }
+        Mix_CloseAudio();
+        audio_open = false;
+    }
+    IMG_Quit();
+    Mix_Quit();
+    SDL_Quit();
+}
 
-    return img;
+/**
+ * Gets the cache entry for the game font at a size,
+ * opening the font the first time that size is used.
+ */
+font_entry_t *get_font_entry(int size) {
+    for (size_t i = 0; i < list_size(fonts); i++) {
+        font_entry_t *entry = list_get(fonts, i);
+        if (entry->size == size) {
+            return entry;
+        }
+    }
+    font_entry_t *entry = malloc(sizeof(font_entry_t));
+    assert(entry != NULL);
+    entry->size = size;
+    entry->font = TTF_OpenFont(FONT_PATH, size);
+    entry->atlas = NULL;
+    if (entry->font == NULL) {
+        printf("TTF_OpenFont: %s\n", TTF_GetError());
+    }
+    // Failures are cached too, so they are only reported once
+    list_add(fonts, entry);
+    return entry;
 }
 
-void center_display(char *message, int text_height, int font_size, int x_pos, int width, int height, rgb_color_t color){
-    SDL_Color textColor = {color.r * 255, color.g * 255, color.b * 255, 255};
-    TTF_Font* font = TTF_OpenFont("resources/gamefont.ttf", font_size);
+/**
+ * Gets the game font at a size.
+ * Returns NULL if the font could not be opened.
+ */
+TTF_Font *get_font(int size) {
+    return get_font_entry(size)->font;
+}
 
-    SDL_Surface *textSurface = TTF_RenderText_Blended(font, message, textColor);
-    SDL_Texture *text = SDL_CreateTextureFromSurface(renderer, textSurface);
+/**
+ * Rasterizes every glyph of a font in white into one texture.
+ * The glyphs are packed left to right in rows of the font's height.
+ */
+glyph_atlas_t *build_glyph_atlas(TTF_Font *font) {
+    glyph_atlas_t *atlas = malloc(sizeof(glyph_atlas_t));
+    assert(atlas != NULL);
+    SDL_Color white = {255, 255, 255, 255};
+    int line_height = TTF_FontHeight(font);
+    SDL_Surface *surfaces[GLYPH_COUNT];
+    int x = 0;
+    int y = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        glyph_t *glyph = &atlas->glyphs[i];
+        int min_x, max_x, min_y, max_y;
+        if (TTF_GlyphMetrics(font, GLYPH_FIRST + i, &min_x, &max_x, &min_y, &max_y, &glyph->advance) < 0) {
+            glyph->advance = 0;
+        }
+        surfaces[i] = TTF_RenderGlyph_Blended(font, GLYPH_FIRST + i, white);
+        int width = surfaces[i] == NULL ? 0 : surfaces[i]->w;
+        int height = surfaces[i] == NULL ? 0 : surfaces[i]->h;
+        if (x + width > GLYPH_ATLAS_WIDTH) {
+            x = 0;
+            y += line_height + 1;
+        }
+        glyph->source = (SDL_Rect) {.x = x, .y = y, .w = width, .h = height};
+        // Leave a pixel between glyphs so filtering does not bleed across them
+        x += width + 1;
+    }
+    atlas->width = GLYPH_ATLAS_WIDTH;
+    atlas->height = y + line_height;
+
+    SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height, 32, SDL_PIXELFORMAT_RGBA32);
+    assert(sheet != NULL);
+    for (int i = 0; i < GLYPH_COUNT; i++) {
+        if (surfaces[i] != NULL) {
+            // Copy the glyph's alpha as is, rather than blending it onto the sheet
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(surfaces[i], NULL, sheet, &atlas->glyphs[i].source);
+            SDL_FreeSurface(surfaces[i]);
+        }
+    }
+    atlas->texture = SDL_CreateTextureFromSurface(renderer, sheet);
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    SDL_FreeSurface(sheet);
+    return atlas;
+}
+
+/**
+ * Gets the glyph atlas of the game font at a size, building it on first use.
+ * Returns NULL if the font could not be opened.
+ */
+glyph_atlas_t *get_glyph_atlas(int size) {
+    font_entry_t *entry = get_font_entry(size);
+    if (entry->font == NULL) {
+        return NULL;
+    }
+    if (entry->atlas == NULL) {
+        entry->atlas = build_glyph_atlas(entry->font);
+    }
+    return entry->atlas;
+}
 
-    SDL_Rect *Message_rect = malloc(sizeof(SDL_Rect));
-    int w = textSurface->w;
-    int h = textSurface->h;
-    Message_rect->x = WINDOW_WIDTH/2 - (w/2);  
-    Message_rect->y = text_height; 
-    Message_rect->w = w; 
-    Message_rect->h = h; 
+void sdl_draw_text(char *message, int x, int y, int font_size, rgb_color_t color) {
+    glyph_atlas_t *atlas = get_glyph_atlas(font_size);
+    if (atlas == NULL) {
+        return;
+    }
+    size_t length = strlen(message);
+    if (length > text_quad_capacity) {
+        text_quad_capacity = length;
+        text_vertices = realloc(text_vertices, sizeof(SDL_Vertex) * 4 * text_quad_capacity);
+        text_indices = realloc(text_indices, sizeof(int) * 6 * text_quad_capacity);
+        assert(text_vertices != NULL && text_indices != NULL);
+    }
 
-    SDL_RenderCopy(renderer, text, NULL, Message_rect);
-    SDL_FreeSurface(textSurface);
-    TTF_CloseFont(font);
+    SDL_Color tint = {color.r * 255, color.g * 255, color.b * 255, 255};
+    int quads = 0;
+    float pen = x;
+    for (size_t i = 0; i < length; i++) {
+        char c = message[i];
+        if (c < GLYPH_FIRST || c > GLYPH_LAST) {
+            c = ' ';
+        }
+        glyph_t *glyph = &atlas->glyphs[c - GLYPH_FIRST];
+        if (glyph->source.w > 0 && glyph->source.h > 0) {
+            SDL_Rect source = glyph->source;
+            float left = pen, top = y, right = pen + source.w, bottom = y + source.h;
+            float u0 = (float) source.x / atlas->width;
+            float v0 = (float) source.y / atlas->height;
+            float u1 = (float) (source.x + source.w) / atlas->width;
+            float v1 = (float) (source.y + source.h) / atlas->height;
+            SDL_Vertex *vertex = &text_vertices[4 * quads];
+            vertex[0] = (SDL_Vertex) {{left, top}, tint, {u0, v0}};
+            vertex[1] = (SDL_Vertex) {{right, top}, tint, {u1, v0}};
+            vertex[2] = (SDL_Vertex) {{right, bottom}, tint, {u1, v1}};
+            vertex[3] = (SDL_Vertex) {{left, bottom}, tint, {u0, v1}};
+            int *index = &text_indices[6 * quads];
+            int first = 4 * quads;
+            index[0] = first;
+            index[1] = first + 1;
+            index[2] = first + 2;
+            index[3] = first;
+            index[4] = first + 2;
+            index[5] = first + 3;
+            quads++;
+        }
+        pen += glyph->advance;
+    }
+    if (quads > 0) {
+        SDL_RenderGeometry(renderer, atlas->texture, text_vertices, 4 * quads, text_indices, 6 * quads);
+    }
 }
 
-void point_display(char *score) {
-    SDL_Color textColor = {0, 51, 102, 255};
-    TTF_Font* font = TTF_OpenFont("resources/gamefont.ttf", 50);
-    if(!font) {
-        printf("TTF_OpenFont: %s\n", TTF_GetError());
+/**
+ * Gets a texture of a string in the game font.
+ * Strings are only rasterized the first time they are drawn
+ * (or after being evicted), so drawing the same text every frame is cheap.
+ * Returns NULL if the text could not be rendered.
+ */
+text_entry_t *render_text(char *message, int font_size, SDL_Color color) {
+    text_clock++;
+    size_t oldest = 0;
+    for (size_t i = 0; i < list_size(texts); i++) {
+        text_entry_t *entry = list_get(texts, i);
+        if (entry->font_size == font_size && entry->color.r == color.r && entry->color.g == color.g
+                && entry->color.b == color.b && entry->color.a == color.a
+                && strcmp(entry->message, message) == 0) {
+            entry->last_used = text_clock;
+            return entry;
+        }
+        if (entry->last_used < ((text_entry_t *) list_get(texts, oldest))->last_used) {
+            oldest = i;
+        }
+    }
+
+    TTF_Font *font = get_font(font_size);
+    if (font == NULL) {
+        return NULL;
     }
-    SDL_Surface *textSurface = TTF_RenderText_Blended(font, score, textColor);
-    int w = textSurface->w;
-    int h = textSurface->h;
+    SDL_Surface *surface = TTF_RenderText_Blended(font, message, color);
+    if (surface == NULL) {
+        return NULL;
+    }
+    if (list_size(texts) == TEXT_CACHE_CAPACITY) {
+        text_entry_free(list_remove(texts, oldest));
+    }
+    text_entry_t *entry = malloc(sizeof(text_entry_t));
+    assert(entry != NULL);
+    entry->message = strdup(message);
+    entry->font_size = font_size;
+    entry->color = color;
+    entry->texture = SDL_CreateTextureFromSurface(renderer, surface);
+    entry->width = surface->w;
+    entry->height = surface->h;
+    entry->last_used = text_clock;
+    SDL_FreeSurface(surface);
+    list_add(texts, entry);
+    return entry;
+}
 
-    SDL_Texture *text = SDL_CreateTextureFromSurface(renderer, textSurface);
+void center_display(char *message, int text_height, int font_size, int x_pos, int width, int height, rgb_color_t color){
+    SDL_Color textColor = {color.r * 255, color.g * 255, color.b * 255, 255};
+    text_entry_t *text = render_text(message, font_size, textColor);
+    if (text == NULL) {
+        return;
+    }
+    SDL_Rect Message_rect = {
+        .x = WINDOW_WIDTH/2 - (text->width/2),
+        .y = text_height,
+        .w = text->width,
+        .h = text->height
+    };
+    SDL_RenderCopy(renderer, text->texture, NULL, &Message_rect);
+}
 
-    SDL_Rect *Message_rect = malloc(sizeof(SDL_Rect));
-    Message_rect->x = 30;
-    Message_rect->y = 30;
-    Message_rect->w = w;
-    Message_rect->h = h;
-    SDL_RenderCopy(renderer, text, NULL, Message_rect);
-    SDL_FreeSurface(textSurface);
-    TTF_CloseFont(font);
+void point_display(char *score) {
+    // The score changes during play, so it is drawn from the glyph atlas
+    sdl_draw_text(score, 30, 30, 50, rgb_color_init(0, 51, 102));
 }
 
 bool sdl_is_done(scene_t *scene) {
-    SDL_Event *event = malloc(sizeof(*event));
-    assert(event != NULL);
-    while (SDL_PollEvent(event)) {
-        switch (event->type) {
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        switch (event.type) {
             case SDL_QUIT:
-                free(event);
                 return true;
+            case SDL_RENDER_TARGETS_RESET:
+            case SDL_RENDER_DEVICE_RESET:
+                // The cached menu and background were lost, so they have to be drawn again
+                menu_valid = false;
+                background_valid = false;
+                break;
             case SDL_KEYDOWN:
             case SDL_KEYUP:
                 // Skip the keypress if no handler is configured
                 // or an unrecognized key was pressed
                 if (key_handler == NULL) break;
-                char key = get_keycode(event->key.keysym.sym);
+                char key = get_keycode(event.key.keysym.sym);
                 if (key == '\0') break;
 
-                uint32_t timestamp = event->key.timestamp;
-                if (!event->key.repeat) {
+                uint32_t timestamp = event.key.timestamp;
+                if (!event.key.repeat) {
                     key_start_timestamp = timestamp;
                 }
                 key_event_type_t type =
-                    event->type == SDL_KEYDOWN ? KEY_PRESSED : KEY_RELEASED;
+                    event.type == SDL_KEYDOWN ? KEY_PRESSED : KEY_RELEASED;
                 double held_time = (timestamp - key_start_timestamp) / MS_PER_S;
                 key_handler(key, type, held_time, scene);
+                if (quit_requested) {
+                    return true;
+                }
                 break;
         }
     }
-    free(event);
     return false;
 }
 
@@ -242,50 +779,82 @@ void sdl_clear(void) {
     SDL_RenderClear(renderer);
 }
 
-void sdl_draw_polygon(body_t *body) {
-    list_t *points = body_get_shape(body);
+/**
+ * Makes room in the batch for more vertices and indices.
+ */
+void reserve_batch(size_t vertices, size_t indices) {
+    if (batch_vertex_count + vertices > batch_vertex_capacity) {
+        batch_vertex_capacity = 2 * (batch_vertex_count + vertices);
+        batch_vertices = realloc(batch_vertices, sizeof(SDL_Vertex) * batch_vertex_capacity);
+        assert(batch_vertices != NULL);
+    }
+    if (batch_index_count + indices > batch_index_capacity) {
+        batch_index_capacity = 2 * (batch_index_count + indices);
+        batch_indices = realloc(batch_indices, sizeof(int) * batch_index_capacity);
+        assert(batch_indices != NULL);
+    }
+}
+
+/**
+ * Draws every batched triangle with one draw call and empties the batch.
+ */
+void flush_batch(void) {
+    if (batch_index_count > 0) {
+        SDL_RenderGeometry(
+            renderer, NULL,
+            batch_vertices, batch_vertex_count,
+            batch_indices, batch_index_count
+        );
+    }
+    batch_vertex_count = 0;
+    batch_index_count = 0;
+}
+
+/**
+ * Draws a polygon from its world vertices, either by batching its triangles
+ * or, if it has a texture, by stretching the texture over its bounding box.
+ */
+void draw_shape(const vector_t *vertices, size_t n, const size_t *triangles,
+                rgb_color_t color, SDL_Texture *texture, vector_t offset) {
     // Check parameters
-    size_t n = list_size(points);
     assert(n >= 3);
 
     vector_t window_center = get_window_center();
 
-    // Convert each vertex to a point on screen
-    int16_t *x_points = malloc(sizeof(*x_points) * n),
-            *y_points = malloc(sizeof(*y_points) * n);
-    assert(x_points != NULL);
-    assert(y_points != NULL);
-    for (size_t i = 0; i < n; i++) {
-        vector_t *vertex = list_get(points, i);
-        vector_t pixel = get_window_position(*vertex, window_center);
-        x_points[i] = pixel.x;
-        y_points[i] = pixel.y;
-    }
-
-    if (body_get_texture(body) == NULL) {
-        rgb_color_t color = body_get_color(body);
+    if (texture == NULL) {
         assert(0 <= color.r && color.r <= 1);
         assert(0 <= color.g && color.g <= 1);
         assert(0 <= color.b && color.b <= 1);
+        SDL_Color vertex_color = {color.r * 255, color.g * 255, color.b * 255, 255};
 
-        // Draw polygon with the given color
-        filledPolygonRGBA(
-            renderer,
-            x_points, y_points, n,
-            color.r * 255, color.g * 255, color.b * 255, 255
-        );
+        size_t triangle_count = n - 2;
+
+        // Add the polygon's vertices and triangles to the batch
+        reserve_batch(n, 3 * triangle_count);
+        size_t first = batch_vertex_count;
+        for (size_t i = 0; i < n; i++) {
+            vector_t pixel = get_window_position(vec_add(vertices[i], offset), window_center);
+            batch_vertices[batch_vertex_count++] = (SDL_Vertex) {
+                .position = {pixel.x, pixel.y},
+                .color = vertex_color
+            };
+        }
+        for (size_t i = 0; i < 3 * triangle_count; i++) {
+            batch_indices[batch_index_count++] = first + triangles[i];
+        }
     }
     // else if (get_type(body) == GRASS) { //For textured grass when texturedPolygon works
     //     texturedPolygon(renderer, x_points, y_points, n, body_get_surface(body), 0, 0);
     // }
     else {
+        // Keep the drawing order: everything batched so far goes under the texture
+        flush_batch();
         double minx = INFINITY;
         double miny = INFINITY;
         double maxx = -INFINITY;
         double maxy = -INFINITY;
-        for (size_t i = 0; i < list_size(points); i++) {
-            vector_t *vertex = list_get(points, i);
-            vector_t curr = get_window_position(*vertex, window_center);
+        for (size_t i = 0; i < n; i++) {
+            vector_t curr = get_window_position(vec_add(vertices[i], offset), window_center);
             if (curr.x < minx) {
                 minx = curr.x;
             }
@@ -299,43 +868,59 @@ void sdl_draw_polygon(body_t *body) {
                 maxy = curr.y;
             }
         }
-        SDL_Rect *rect = malloc(sizeof(SDL_Rect));
-        rect->x = minx; rect->y = miny;
-        rect->w = maxx - minx; rect->h = maxy - miny;
-        SDL_RenderCopy(renderer, body_get_texture(body), NULL, rect);
-        free(rect);
-    }   
-    free(x_points);
-    free(y_points);
-    free(points);
+        SDL_Rect rect = {.x = minx, .y = miny, .w = maxx - minx, .h = maxy - miny};
+        SDL_RenderCopy(renderer, texture, NULL, &rect);
+    }
+}
+
+/**
+ * Draws a polygon representing the body, as it is now.
+ * Untextured bodies are triangulated and added to a batch, which is drawn
+ * with a single SDL_RenderGeometry() call by sdl_show(), or sooner if a
+ * textured body has to be drawn on top of it.
+ * Only used for the background, which does not move during play;
+ * bodies are drawn from published snapshots instead.
+ */
+void sdl_draw_polygon(body_t *body, vector_t offset) {
+    const polygon_t *shape = body_get_shape_view(body);
+    SDL_Texture *texture = body_get_texture(body);
+    draw_shape(
+        polygon_vertices(shape), polygon_size(shape),
+        texture == NULL ? body_get_triangles(body) : NULL,
+        body_get_color(body), texture, offset
+    );
 }
 
 void sdl_show(void) {
+    flush_batch();
     // Draw boundary lines
     vector_t window_center = get_window_center();
     vector_t max = vec_add(center, max_diff),
              min = vec_subtract(center, max_diff);
     vector_t max_pixel = get_window_position(max, window_center),
              min_pixel = get_window_position(min, window_center);
-    SDL_Rect *boundary = malloc(sizeof(*boundary));
-    boundary->x = min_pixel.x;
-    boundary->y = max_pixel.y;
-    boundary->w = max_pixel.x - min_pixel.x;
-    boundary->h = min_pixel.y - max_pixel.y;
+    SDL_Rect boundary = {
+        .x = min_pixel.x,
+        .y = max_pixel.y,
+        .w = max_pixel.x - min_pixel.x,
+        .h = min_pixel.y - max_pixel.y
+    };
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, boundary);
-    free(boundary);
+    SDL_RenderDrawRect(renderer, &boundary);
 
     SDL_RenderPresent(renderer);
 }
 
-void sdl_render_scene(scene_t *scene) {
-    sdl_clear();
-    int state = scene_get_state(scene);
-    if (state == -5) {
-        char *filepath = "../resources/intro_img.png";
-        scene_set_img(scene, sdl_load_image(filepath));
+/**
+ * Draws the menu screen for a state other than 0 (playing).
+ */
+void draw_menu(int state, size_t points, size_t level) {
+    int w, h;
+    SDL_QueryTexture(menu_image, NULL, NULL, &w, &h);
+    SDL_Rect texr = {.x = 0, .y = 0, .w = w/2.15, .h = h/2.8};
+    SDL_RenderCopy(renderer, menu_image, NULL, &texr);
 
+    if (state == -5) {
         center_display(("Welcome to Flappy Golf!"), 60, 40, 320, 400, 100, rgb_color_rainbows(3));
 
         center_display(("Use left & right arrows to control the ball."), 190, 30, 440, 130, 70, rgb_color_rainbows(0));
@@ -344,19 +929,16 @@ void sdl_render_scene(scene_t *scene) {
         center_display("Press 'q' at any time to quit.", 320, 30, 450, 200, 80, rgb_color_rainbows(1));
     }
     else if (state == -1) {
-        char *filepath = "../resources/intro_img.png";
-        scene_set_img(scene, sdl_load_image(filepath));
-
         center_display(("You Lost this Level!"), 60, 40, 320, 400, 100, rgb_color_rainbows(3));
 
         char score_str[50];
-        sprintf(score_str, "%zu", scene_get_points(scene));
+        sprintf(score_str, "%zu", points);
         char str1[100] = "Flaps: ";
         strcat(str1, score_str);
         center_display(str1, 140, 30, 440, 130, 70, rgb_color_rainbows(1));
 
         char level_str[50];
-        sprintf(level_str, "%zu", scene_get_level(scene));
+        sprintf(level_str, "%zu", level);
         char str2[100] = "Level: ";
         strcat(str2, level_str);
         center_display(str2, 190, 30, 450, 200, 80, rgb_color_rainbows(1));
@@ -365,19 +947,15 @@ void sdl_render_scene(scene_t *scene) {
 
     }
     else if (state == 1) {
-        char *filepath = "../resources/intro_img.png";
-        scene_set_img(scene, sdl_load_image(filepath));
-
-        body_set_velocity(scene_get_body(scene, 0), VEC_ZERO); //necessary to stop the ball from "rolling" even when game is done.
         center_display(("You Win this Level!"), 60, 40, 320, 400, 100, rgb_color_rainbows(3));
         char score_str[50];
-        sprintf(score_str, "%zu", scene_get_points(scene));
+        sprintf(score_str, "%zu", points);
         char str1[100] = "Flaps: ";
         strcat(str1, score_str);
         center_display(str1, 140, 30, 440, 130, 70, rgb_color_rainbows(1));
 
         char level_str[50];
-        sprintf(level_str, "%zu", scene_get_level(scene));
+        sprintf(level_str, "%zu", level);
         char str2[100] = "Level: ";
         strcat(str2, level_str);
         center_display(str2, 190, 30, 450, 200, 80, rgb_color_rainbows(1));
@@ -385,37 +963,17 @@ void sdl_render_scene(scene_t *scene) {
         center_display("Press space to retry.", 260, 30, 370, 250, 50, rgb_color_rainbows(0));
         center_display("Press up arrow to continue.", 310, 30, 330, 280, 45, rgb_color_rainbows(0));
     }
-    else if (state == 0) {
-        size_t background_element_count = scene_background_elements(scene);
-        for (size_t i = 0; i < background_element_count; i++) {
-            body_t *body = scene_get_background_element(scene, i);
-            sdl_draw_polygon(body);
-        }
-        size_t body_count = scene_bodies(scene);
-        for (size_t i = 0; i < body_count; i++) {
-            body_t *body = scene_get_body(scene, i);
-            sdl_draw_polygon(body);
-        }
-        char score_str[10];
-        sprintf(score_str, "%zu", scene_get_points(scene));
-        char str1[100] = "Flaps: ";
-        strcat(str1, score_str);
-        point_display(str1);
-    }
     else if (state == 2) {
-        char *filepath = "../resources/intro_img.png";
-        sdl_load_image(filepath);
-
         center_display(("You've won all the levels. Good job!"), 60, 40, 320, 400, 100, rgb_color_rainbows(3));
 
         char score_str[50];
-        sprintf(score_str, "%zu", scene_get_points(scene));
+        sprintf(score_str, "%zu", points);
         char str1[100] = "Flaps: ";
         strcat(str1, score_str);
         center_display(str1, 140, 30, 440, 130, 70, rgb_color_rainbows(1));
 
         char level_str[50];
-        sprintf(level_str, "%zu", scene_get_level(scene));
+        sprintf(level_str, "%zu", level);
         char str2[100] = "Level: ";
         strcat(str2, level_str);
         center_display(str2, 190, 30, 400, 200, 80, rgb_color_rainbows(1));
@@ -423,19 +981,297 @@ void sdl_render_scene(scene_t *scene) {
         center_display("Press space to retry this level.", 260, 30, 370, 250, 50, rgb_color_rainbows(0));
         center_display("Press 'q' to quit.", 310, 30, 330, 280, 45, rgb_color_rainbows(0));
     }
+}
+
+/**
+ * Draws the menu screen of a snapshot, from menu_target when its inputs
+ * are the same as last time, and otherwise redrawing menu_target first.
+ */
+void render_menu(render_snapshot_t *snapshot) {
+    int width, height;
+    SDL_GetRendererOutputSize(renderer, &width, &height);
+    menu_key_t key = {
+        .state = snapshot->state,
+        .points = snapshot->points,
+        .level = snapshot->level,
+        .width = width,
+        .height = height
+    };
+    if (menu_target == NULL || width != menu_key.width || height != menu_key.height) {
+        if (menu_target != NULL) {
+            SDL_DestroyTexture(menu_target);
+        }
+        menu_target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+        menu_valid = false;
+    }
+    if (!menu_valid || key.state != menu_key.state || key.points != menu_key.points
+            || key.level != menu_key.level) {
+        SDL_SetRenderTarget(renderer, menu_target);
+        sdl_clear();
+        draw_menu(key.state, key.points, key.level);
+        SDL_SetRenderTarget(renderer, NULL);
+        menu_key = key;
+        menu_valid = true;
+    }
+    SDL_RenderCopy(renderer, menu_target, NULL, NULL);
+}
+
+/**
+ * Checks whether any of a bounding box, drawn at an offset,
+ * lands inside the window.
+ */
+bool box_on_screen(vector_t min, vector_t max, vector_t offset, vector_t window_center) {
+    // Positive y is down on the screen, so the box's top left is (min.x, max.y)
+    vector_t top_left = get_window_position(vec_add((vector_t) {min.x, max.y}, offset), window_center);
+    vector_t bottom_right = get_window_position(vec_add((vector_t) {max.x, min.y}, offset), window_center);
+    return bottom_right.x >= 0 && top_left.x <= 2 * window_center.x
+        && bottom_right.y >= 0 && top_left.y <= 2 * window_center.y;
+}
+
+/**
+ * Draws every background element of a scene into background_target,
+ * cropped to their bounding box. Leaves background_target NULL if the
+ * box is too large for a texture.
+ */
+void prerender_background(scene_t *scene, vector_t window_center) {
+    if (background_target != NULL) {
+        SDL_DestroyTexture(background_target);
+        background_target = NULL;
+    }
+    size_t count = scene_background_elements(scene);
+    if (count == 0) {
+        return;
+    }
+    vector_t min, max;
+    polygon_bounds(body_get_shape_view(scene_get_background_element(scene, 0)), &min, &max);
+    for (size_t i = 1; i < count; i++) {
+        vector_t body_min, body_max;
+        polygon_bounds(body_get_shape_view(scene_get_background_element(scene, i)), &body_min, &body_max);
+        min = (vector_t) {fmin(min.x, body_min.x), fmin(min.y, body_min.y)};
+        max = (vector_t) {fmax(max.x, body_max.x), fmax(max.y, body_max.y)};
+    }
+    background_corner = (vector_t) {min.x, max.y};
+    vector_t top_left = get_window_position(background_corner, window_center);
+    vector_t bottom_right = get_window_position((vector_t) {max.x, min.y}, window_center);
+    background_width = bottom_right.x - top_left.x + 1;
+    background_height = bottom_right.y - top_left.y + 1;
+    background_target = SDL_CreateTexture(
+        renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+        background_width, background_height
+    );
+    if (background_target == NULL) {
+        return;
+    }
+    SDL_SetTextureBlendMode(background_target, SDL_BLENDMODE_BLEND);
+
+    // Shift the elements so the corner lands on the texture's top left pixel
+    double scale = get_scene_scale(window_center);
+    vector_t offset = {
+        .x = -top_left.x / scale,
+        .y = top_left.y / scale
+    };
+    flush_batch();
+    SDL_SetRenderTarget(renderer, background_target);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+    for (size_t i = 0; i < count; i++) {
+        sdl_draw_polygon(scene_get_background_element(scene, i), offset);
+    }
+    flush_batch();
+    SDL_SetRenderTarget(renderer, NULL);
+}
+
+/**
+ * Draws the background elements of a scene as a single texture copy,
+ * drawing them into background_target first if they or the window changed.
+ * Falls back to drawing each element if the layer does not fit in a texture.
+ */
+void draw_background(scene_t *scene, vector_t offset) {
+    vector_t window_center = get_window_center();
+    background_key_t key = {
+        .scene = scene,
+        .count = scene_background_elements(scene),
+        .first = scene_background_elements(scene) > 0 ? scene_get_background_element(scene, 0) : NULL,
+        .width = 2 * window_center.x,
+        .height = 2 * window_center.y
+    };
+    if (!background_valid || key.scene != background_key.scene || key.count != background_key.count
+            || key.first != background_key.first || key.width != background_key.width || key.height != background_key.height) {
+        prerender_background(scene, window_center);
+        background_key = key;
+        background_valid = true;
+    }
+    if (background_target == NULL) {
+        for (size_t i = 0; i < key.count; i++) {
+            body_t *body = scene_get_background_element(scene, i);
+            vector_t min, max;
+            body_get_bounds(body, &min, &max);
+            if (box_on_screen(min, max, offset, window_center)) {
+                sdl_draw_polygon(body, offset);
+            }
+        }
+        return;
+    }
+    flush_batch();
+    vector_t top_left = get_window_position(vec_add(background_corner, offset), window_center);
+    SDL_Rect destination = {
+        .x = top_left.x,
+        .y = top_left.y,
+        .w = background_width,
+        .h = background_height
+    };
+    SDL_RenderCopy(renderer, background_target, NULL, &destination);
+}
+
+/**
+ * Makes room in a snapshot for more bodies, vertices, and triangle indices.
+ */
+void reserve_snapshot(render_snapshot_t *snapshot, size_t bodies, size_t vertices, size_t indices) {
+    if (snapshot->body_count + bodies > snapshot->body_capacity) {
+        snapshot->body_capacity = 2 * (snapshot->body_count + bodies);
+        snapshot->bodies = realloc(snapshot->bodies, sizeof(body_snapshot_t) * snapshot->body_capacity);
+        assert(snapshot->bodies != NULL);
+    }
+    if (snapshot->vertex_count + vertices > snapshot->vertex_capacity) {
+        snapshot->vertex_capacity = 2 * (snapshot->vertex_count + vertices);
+        snapshot->vertices = realloc(snapshot->vertices, sizeof(vector_t) * snapshot->vertex_capacity);
+        assert(snapshot->vertices != NULL);
+    }
+    if (snapshot->index_count + indices > snapshot->index_capacity) {
+        snapshot->index_capacity = 2 * (snapshot->index_count + indices);
+        snapshot->triangles = realloc(snapshot->triangles, sizeof(size_t) * snapshot->index_capacity);
+        assert(snapshot->triangles != NULL);
+    }
+}
+
+/**
+ * Copies what is drawn of a scene into a snapshot.
+ */
+void capture_scene(render_snapshot_t *snapshot, scene_t *scene) {
+    snapshot->state = scene_get_state(scene);
+    snapshot->points = scene_get_points(scene);
+    snapshot->level = scene_get_level(scene);
+    snapshot->background_start = scene_get_view_offset(scene, SCENE_LAYER_BACKGROUND, 0);
+    snapshot->background_end = scene_get_view_offset(scene, SCENE_LAYER_BACKGROUND, 1);
+    snapshot->bodies_start = scene_get_view_offset(scene, SCENE_LAYER_BODIES, 0);
+    snapshot->bodies_end = scene_get_view_offset(scene, SCENE_LAYER_BODIES, 1);
+    snapshot->body_count = 0;
+    snapshot->vertex_count = 0;
+    snapshot->index_count = 0;
+
+    size_t body_count = scene_bodies(scene);
+    reserve_snapshot(snapshot, body_count, 0, 0);
+    for (size_t i = 0; i < body_count; i++) {
+        body_t *body = scene_get_body(scene, i);
+        const polygon_t *shape = body_get_shape_view(body);
+        size_t n = polygon_size(shape);
+        SDL_Texture *texture = body_get_texture(body);
+        size_t indices = texture == NULL ? 3 * (n - 2) : 0;
+        reserve_snapshot(snapshot, 0, n, indices);
+
+        body_snapshot_t *copy = &snapshot->bodies[snapshot->body_count++];
+        copy->first_vertex = snapshot->vertex_count;
+        copy->vertex_count = n;
+        copy->first_index = snapshot->index_count;
+        copy->color = body_get_color(body);
+        copy->texture = texture;
+        body_get_bounds(body, &copy->min, &copy->max);
+        copy->motion = vec_subtract(body_get_centroid(body), body_get_previous_centroid(body));
+
+        memcpy(&snapshot->vertices[snapshot->vertex_count], polygon_vertices(shape), sizeof(vector_t) * n);
+        snapshot->vertex_count += n;
+        if (indices > 0) {
+            memcpy(&snapshot->triangles[snapshot->index_count], body_get_triangles(body), sizeof(size_t) * indices);
+            snapshot->index_count += indices;
+        }
+    }
+}
+
+void sdl_publish_scene(scene_t *scene) {
+    render_snapshot_t *snapshot = &snapshots[write_snapshot];
+    capture_scene(snapshot, scene);
+    snapshot->published = SDL_GetPerformanceCounter();
+    // The snapshot must be complete before the drawer can take it
+    SDL_MemoryBarrierRelease();
+    int previous = SDL_AtomicSet(&latest_snapshot, write_snapshot | SNAPSHOT_FRESH);
+    write_snapshot = previous & ~SNAPSHOT_FRESH;
+}
+
+/**
+ * Takes the latest published snapshot, if one was published since the last call.
+ * Returns the snapshot to draw.
+ */
+render_snapshot_t *take_snapshot(void) {
+    if (SDL_AtomicGet(&latest_snapshot) & SNAPSHOT_FRESH) {
+        int latest = SDL_AtomicSet(&latest_snapshot, read_snapshot);
+        SDL_MemoryBarrierAcquire();
+        read_snapshot = latest & ~SNAPSHOT_FRESH;
+    }
+    return &snapshots[read_snapshot];
+}
+
+/**
+ * Finds the point alpha of the way from start to end.
+ */
+vector_t interpolate(vector_t start, vector_t end, double alpha) {
+    return vec_add(start, vec_multiply(alpha, vec_subtract(end, start)));
+}
+
+/**
+ * Draws a frame from a snapshot, alpha of the way from its previous tick
+ * to its latest one. The background is drawn from the scene.
+ */
+void draw_snapshot(scene_t *scene, render_snapshot_t *snapshot, double alpha) {
+    sdl_clear();
+    if (snapshot->state == 0) {
+        draw_background(scene, interpolate(snapshot->background_start, snapshot->background_end, alpha));
+        vector_t body_offset = interpolate(snapshot->bodies_start, snapshot->bodies_end, alpha);
+        vector_t window_center = get_window_center();
+        for (size_t i = 0; i < snapshot->body_count; i++) {
+            body_snapshot_t *body = &snapshot->bodies[i];
+            // Draw the body where it was partway through the last tick
+            vector_t offset = vec_add(body_offset, vec_multiply(alpha - 1, body->motion));
+            // Skip bodies entirely outside the window
+            if (box_on_screen(body->min, body->max, offset, window_center)) {
+                draw_shape(
+                    &snapshot->vertices[body->first_vertex], body->vertex_count,
+                    body->texture == NULL ? &snapshot->triangles[body->first_index] : NULL,
+                    body->color, body->texture, offset
+                );
+            }
+        }
+        char score_str[10];
+        sprintf(score_str, "%zu", snapshot->points);
+        char str1[100] = "Flaps: ";
+        strcat(str1, score_str);
+        point_display(str1);
+    }
+    else {
+        render_menu(snapshot);
+    }
     sdl_show();
 }
 
+void sdl_render_snapshot(scene_t *scene, double step) {
+    render_snapshot_t *snapshot = take_snapshot();
+    double elapsed = (double) (SDL_GetPerformanceCounter() - snapshot->published) / SDL_GetPerformanceFrequency();
+    draw_snapshot(scene, snapshot, fmin(1, elapsed / step));
+}
+
 
 void sdl_on_key(key_handler_t handler, void *aux) {
     key_handler = handler;
 }
 
+void sdl_request_quit(void) {
+    quit_requested = true;
+}
+
 double time_since_last_tick(void) {
-    clock_t now = clock();
-    double difference = last_clock
-        ? (double) (now - last_clock) / CLOCKS_PER_SEC
+    Uint64 now = SDL_GetPerformanceCounter();
+    double difference = last_counter
+        ? (double) (now - last_counter) / SDL_GetPerformanceFrequency()
         : 0.0; // return 0 the first time this is called
-    last_clock = now;
+    last_counter = now;
     return difference;
 }
@@ -0,0 +1,172 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+#include "spatial_hash.h"
+#include "list.h"
+#include "vector.h"
+
+const size_t SPATIAL_HASH_BUCKETS = 1024; // Must be a power of 2
+
+typedef struct spatial_entry {
+    void *item;
+    vector_t min;
+    vector_t max;
+    // Range of cells covered by the bounding box
+    int cell_min_x;
+    int cell_min_y;
+    int cell_max_x;
+    int cell_max_y;
+    // Query the entry was last reported by, to report each entry once per query
+    size_t stamp;
+} spatial_entry_t;
+
+typedef struct cell {
+    int x;
+    int y;
+    list_t *entries;
+    struct cell *next;
+} cell_t;
+
+typedef struct spatial_hash {
+    double cell_size;
+    cell_t **buckets;
+    list_t *entries;
+    size_t stamp;
+} spatial_hash_t;
+
+spatial_hash_t *spatial_hash_init(double cell_size) {
+    assert(cell_size > 0);
+    spatial_hash_t *hash = malloc(sizeof(spatial_hash_t));
+    assert(hash != NULL);
+    hash->cell_size = cell_size;
+    hash->buckets = calloc(SPATIAL_HASH_BUCKETS, sizeof(cell_t *));
+    assert(hash->buckets != NULL);
+    hash->entries = list_init(16, free);
+    hash->stamp = 0;
+    return hash;
+}
+
+void spatial_hash_free(spatial_hash_t *hash) {
+    for (size_t i = 0; i < SPATIAL_HASH_BUCKETS; i++) {
+        cell_t *cell = hash->buckets[i];
+        while (cell != NULL) {
+            cell_t *next = cell->next;
+            list_free(cell->entries);
+            free(cell);
+            cell = next;
+        }
+    }
+    free(hash->buckets);
+    list_free(hash->entries);
+    free(hash);
+}
+
+void spatial_hash_clear(spatial_hash_t *hash) {
+    // Keep the cells, so inserting the same boxes again does not allocate them
+    for (size_t i = 0; i < SPATIAL_HASH_BUCKETS; i++) {
+        for (cell_t *cell = hash->buckets[i]; cell != NULL; cell = cell->next) {
+            list_clear(cell->entries);
+        }
+    }
+    list_clear(hash->entries);
+}
+
+size_t spatial_hash_size(spatial_hash_t *hash) {
+    return list_size(hash->entries);
+}
+
+size_t cell_bucket(int x, int y) {
+    // Large primes spread neighbouring cells across the table
+    uint32_t h = ((uint32_t) x * 73856093u) ^ ((uint32_t) y * 19349663u);
+    return h & (SPATIAL_HASH_BUCKETS - 1);
+}
+
+int cell_coordinate(spatial_hash_t *hash, double v) {
+    return (int) floor(v / hash->cell_size);
+}
+
+cell_t *find_cell(spatial_hash_t *hash, int x, int y, bool create) {
+    size_t bucket = cell_bucket(x, y);
+    for (cell_t *cell = hash->buckets[bucket]; cell != NULL; cell = cell->next) {
+        if (cell->x == x && cell->y == y) {
+            return cell;
+        }
+    }
+    if (!create) {
+        return NULL;
+    }
+    cell_t *cell = malloc(sizeof(cell_t));
+    assert(cell != NULL);
+    cell->x = x;
+    cell->y = y;
+    cell->entries = list_init(4, NULL);
+    cell->next = hash->buckets[bucket];
+    hash->buckets[bucket] = cell;
+    return cell;
+}
+
+void spatial_hash_insert(spatial_hash_t *hash, void *item, vector_t min, vector_t max) {
+    assert(item != NULL);
+    spatial_entry_t *entry = malloc(sizeof(spatial_entry_t));
+    assert(entry != NULL);
+    entry->item = item;
+    entry->min = min;
+    entry->max = max;
+    entry->cell_min_x = cell_coordinate(hash, min.x);
+    entry->cell_min_y = cell_coordinate(hash, min.y);
+    entry->cell_max_x = cell_coordinate(hash, max.x);
+    entry->cell_max_y = cell_coordinate(hash, max.y);
+    entry->stamp = hash->stamp;
+    list_add(hash->entries, entry);
+
+    for (int x = entry->cell_min_x; x <= entry->cell_max_x; x++) {
+        for (int y = entry->cell_min_y; y <= entry->cell_max_y; y++) {
+            list_add(find_cell(hash, x, y, true)->entries, entry);
+        }
+    }
+}
+
+void spatial_hash_remove(spatial_hash_t *hash, void *item) {
+    for (size_t i = 0; i < list_size(hash->entries); i++) {
+        spatial_entry_t *entry = list_get(hash->entries, i);
+        if (entry->item != item) {
+            continue;
+        }
+        for (int x = entry->cell_min_x; x <= entry->cell_max_x; x++) {
+            for (int y = entry->cell_min_y; y <= entry->cell_max_y; y++) {
+                list_delete(find_cell(hash, x, y, false)->entries, entry);
+            }
+        }
+        free(list_remove(hash->entries, i));
+        return;
+    }
+}
+
+void spatial_hash_query(spatial_hash_t *hash, vector_t min, vector_t max, list_t *results) {
+    hash->stamp++;
+    int cell_min_x = cell_coordinate(hash, min.x);
+    int cell_min_y = cell_coordinate(hash, min.y);
+    int cell_max_x = cell_coordinate(hash, max.x);
+    int cell_max_y = cell_coordinate(hash, max.y);
+    for (int x = cell_min_x; x <= cell_max_x; x++) {
+        for (int y = cell_min_y; y <= cell_max_y; y++) {
+            cell_t *cell = find_cell(hash, x, y, false);
+            if (cell == NULL) {
+                continue;
+            }
+            for (size_t i = 0; i < list_size(cell->entries); i++) {
+                spatial_entry_t *entry = list_get(cell->entries, i);
+                if (entry->stamp == hash->stamp) {
+                    continue;
+                }
+                entry->stamp = hash->stamp;
+                if (entry->min.x <= max.x && min.x <= entry->max.x &&
+                    entry->min.y <= max.y && min.y <= entry->max.y) {
+                    list_add(results, entry->item);
+                }
+            }
+        }
+    }
+}
@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdbool.h>
+#include <string.h>
+#include <assert.h>
 #include "terrain.h"
 #include "render.h"
 #include "sdl_wrapper.h"
@@ -11,6 +13,7 @@
 #include "level_handlers.h"
 #include "elements.h"
 #include "cJSON.h"
+#include "level_file.h"
 
 #define G 6.67E-11 // N m^2 / kg^2
 #define M 6E24 // kg
@@ -27,6 +30,7 @@ const double BUFFER = 1000;
 const double WATER_LENGTH = 10;
 const double WATER_HEIGHT = 50;
 const double HOLE_RADIUS = 30;
+const size_t LEVEL_PROTOTYPES_INIT_CAPACITY = 8;
 const rgb_color_t WATER_COLOR = {.r = .196, .g = 0.666, .b = 0.8117};
 const rgb_color_t GRASS_COLOR = {.r = 0.278, .g = .722, .b = 0.408};
 const rgb_color_t SKY_COLOR = {.r = 0.651, .g = 0.914, .b = 0.953};
@@ -41,16 +45,16 @@ const double GRASS_ELAS = 0.7;
 const double LV1_HOLE_X = 1975;
 const double LV1_HOLE_Y= 13;
 
-list_t *generate_grass_shape(){
-    list_t *vertices = list_init(3, free);
+polygon_t *generate_grass_shape(){
+    polygon_t *vertices = polygon_init(3);
 
-    list_add(vertices, vec_init_ptr(0, 0));
-    list_add(vertices, vec_init_ptr(0, 500));
-    list_add(vertices, vec_init_ptr(2000, 0));
+    polygon_add(vertices, vec_init(0, 0));
+    polygon_add(vertices, vec_init(0, 500));
+    polygon_add(vertices, vec_init(2000, 0));
     return vertices;
 }
 
-body_t *generate_grass(scene_t *scene, body_t *ball, list_t *shape) {
+body_t *generate_grass(scene_t *scene, body_t *ball, polygon_t *shape) {
     body_t *grass = body_init_with_info(shape, INFINITY, GRASS_COLOR, make_type_info(GRASS), free);
     // SDL_Surface *grass_surf = malloc(sizeof(SDL_Surface)); //For when texturedPolygon works
     // grass_surf = IMG_Load("../resources/grass_texture.png");
@@ -59,7 +63,7 @@ body_t *generate_grass(scene_t *scene, body_t *ball, list_t *shape) {
     return grass;
 }
 
-body_t *generate_water(scene_t *scene, body_t *ball, list_t *shape) {
+body_t *generate_water(scene_t *scene, body_t *ball, polygon_t *shape) {
     body_t *water = body_init_with_info(shape, INFINITY, WATER_COLOR, make_type_info(WATER), free);
     SDL_Texture *water_tex = sdl_load_texture("../resources/water_texture.png");
     body_set_texture(water, water_tex);
@@ -67,7 +71,7 @@ body_t *generate_water(scene_t *scene, body_t *ball, list_t *shape) {
     return water;
 }
 
-body_t *generate_sand(scene_t *scene, body_t *ball, list_t *shape) {
+body_t *generate_sand(scene_t *scene, body_t *ball, polygon_t *shape) {
     body_t *sand = body_init_with_info(shape, INFINITY, SAND_COLOR, make_type_info(SAND), free);
     SDL_Texture *sand_tex = sdl_load_texture("../resources/sand_texture.png");
     body_set_texture(sand, sand_tex);
@@ -75,7 +79,7 @@ body_t *generate_sand(scene_t *scene, body_t *ball, list_t *shape) {
     return sand;
 }
 
-body_t *generate_boost(scene_t *scene, body_t *ball, list_t *shape) {
+body_t *generate_boost(scene_t *scene, body_t *ball, polygon_t *shape) {
     body_t *boost = body_init_with_info(shape, INFINITY, rgb_color_pastel(), make_type_info(BOOST), free);
     SDL_Texture *boost_tex = sdl_load_texture("../resources/glitter_star.png");
     body_set_texture(boost, boost_tex);
@@ -83,7 +87,7 @@ body_t *generate_boost(scene_t *scene, body_t *ball, list_t *shape) {
     return boost;
 }
 
-body_t *generate_portals(scene_t *scene, body_t *ball, list_t *shape, list_t *out_shape, vector_t dir) {
+body_t *generate_portals(scene_t *scene, body_t *ball, polygon_t *shape, polygon_t *out_shape, vector_t dir) {
     body_t *in = body_init_with_info(shape, INFINITY, T_IN_COLOR, make_type_info(PORTAL), free);
     SDL_Texture *in_portal_tex = sdl_load_texture("../resources/in_portal_sprite.jpg");
     body_set_texture(in, in_portal_tex);
@@ -100,7 +104,7 @@ body_t *generate_portals(scene_t *scene, body_t *ball, list_t *shape, list_t *ou
 
 body_t *get_gravity_body(scene_t *scene) {
     // Will be offscreen, so shape is irrelevant
-    list_t *gravity_ball = create_rectangle_shape(1, 1);
+    polygon_t *gravity_ball = create_rectangle_shape(1, 1);
     body_t *body = body_init_with_info(
         gravity_ball,
         M,
@@ -132,152 +136,199 @@ void set_frame(scene_t *scene, body_t *ball, vector_t size) {
     scene_add_body(scene, bottom);
 }
 
-char* read_file(char *path) {
-    FILE *f = fopen(path, "r");
-    
-    if (f == NULL) {
-        return NULL;
+polygon_t *read_shape(const cJSON *vertices) {
+    polygon_t *shape = polygon_init(cJSON_GetArraySize(vertices));
+    const cJSON *vertex_p = NULL;
+    cJSON_ArrayForEach(vertex_p, vertices)
+    {
+        cJSON *x_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "x");
+        cJSON *y_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "y");
+        polygon_add(shape, vec_init(x_p->valuedouble, y_p->valuedouble));
     }
+    return shape;
+}
 
-    char *result = malloc(sizeof(char));
-    char *res = malloc(100);
-    res[0] = '\0'; // initialize longest word
-    size_t current_length = 0;
-
-    int successful = fread(result, 1, 1, f); // reads first character
-    // fread in while as before
-    while (successful == 1) {
-        res[current_length] = result[0];
-        res = realloc(res, current_length + 100);
-        current_length++;
-        successful = fread(result, 1, 1, f);
+/**
+ * Triangulates the shape of every body and background element in a scene,
+ * so it happens while a level loads instead of when it is first drawn.
+ * Bodies that are already triangulated are skipped.
+ */
+void triangulate_bodies(scene_t *scene) {
+    for (size_t i = 0; i < scene_bodies(scene); i++) {
+        body_get_triangles(scene_get_body(scene, i));
+    }
+    for (size_t i = 0; i < scene_background_elements(scene); i++) {
+        body_get_triangles(scene_get_background_element(scene, i));
     }
-    res[current_length] = '\0';
-    free(result);
-    fclose(f);
-    return res;
 }
 
-void generate_level(scene_t *scene, body_t *ball, char* level) {
-    char *data = read_file(level);
-    const cJSON *bounds = NULL;
-    const cJSON *objects = NULL;
-    const cJSON *object = NULL;
-    int status = 0;
-    cJSON *monitor_json = cJSON_Parse(data);
-    if (monitor_json == NULL) {
-        const char *error_ptr = cJSON_GetErrorPtr();
-        if (error_ptr != NULL)
-        {
-            fprintf(stderr, "Error before: %s\n", error_ptr);
+/**
+ * Makes a polygon from a range of a level's vertices.
+ */
+polygon_t *level_shape(const level_t *level, uint32_t first, uint32_t count) {
+    polygon_t *shape = polygon_init(count);
+    for (uint32_t i = 0; i < count; i++) {
+        polygon_add(shape, level->vertices[first + i]);
+    }
+    return shape;
+}
+
+/**
+ * The levels loaded so far, as level_prototype_t's. Each level file is
+ * read and parsed once; retrying or returning to a level builds it from here.
+ */
+list_t *level_prototypes = NULL;
+
+typedef struct level_prototype {
+    char *path;
+    // Never changed once loaded; NULL if the level could not be loaded
+    level_t *level;
+} level_prototype_t;
+
+void level_prototype_free(level_prototype_t *prototype) {
+    if (prototype->level != NULL) {
+        level_free(prototype->level);
+    }
+    free(prototype->path);
+    free(prototype);
+}
+
+/**
+ * Finds the prototype loaded from a level file, or NULL if it has not been loaded.
+ */
+level_prototype_t *find_level_prototype(const char *path) {
+    if (level_prototypes == NULL) {
+        level_prototypes = list_init(LEVEL_PROTOTYPES_INIT_CAPACITY, (free_func_t) level_prototype_free);
+    }
+    for (size_t i = 0; i < list_size(level_prototypes); i++) {
+        level_prototype_t *prototype = list_get(level_prototypes, i);
+        if (strcmp(prototype->path, path) == 0) {
+            return prototype;
         }
-        status = 0;
-        goto end;
     }
-    bounds = cJSON_GetObjectItemCaseSensitive(monitor_json, "bounds");
-    cJSON *width = cJSON_GetObjectItemCaseSensitive(bounds, "width");
-    cJSON *height = cJSON_GetObjectItemCaseSensitive(bounds, "height");
-    vector_t bound_val = vec_init(width->valuedouble, height->valuedouble);
+    return NULL;
+}
 
-    set_frame(scene, ball, bound_val);
+/**
+ * Adds a level, or NULL for one that could not be loaded, to the kept levels.
+ */
+level_prototype_t *keep_level_prototype(const char *path, level_t *level) {
+    level_prototype_t *prototype = malloc(sizeof(level_prototype_t));
+    assert(prototype != NULL);
+    prototype->path = strdup(path);
+    assert(prototype->path != NULL);
+    prototype->level = level;
+    list_add(level_prototypes, prototype);
+    return prototype;
+}
 
-    objects = cJSON_GetObjectItemCaseSensitive(monitor_json, "objects");
-    cJSON_ArrayForEach(object, objects)
-    {
-        cJSON *type_p = cJSON_GetObjectItemCaseSensitive(object, "type");
-        cJSON *pos_x_p = cJSON_GetObjectItemCaseSensitive(object, "pos_x");
-        cJSON *pos_y_p = cJSON_GetObjectItemCaseSensitive(object, "pos_y");
-        cJSON *shape_p = NULL;
-        list_t *shape = NULL;
-        char* type = type_p->valuestring;
-        double pos_x = pos_x_p->valuedouble;
-        double pos_y = pos_y_p->valuedouble;
-        
-        if(strcmp(type, "GRASS") == 0 || strcmp(type, "WATER") == 0 ||
-           strcmp(type, "SAND") == 0 || strcmp(type, "TELEPORT") == 0) {
-            shape_p = cJSON_GetObjectItemCaseSensitive(object, "shape");
-            cJSON *vertex_p = NULL;
-            shape = list_init(5, free);
-            cJSON_ArrayForEach(vertex_p, shape_p)
-            {
-                cJSON *x_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "x");
-                cJSON *y_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "y");
-                vector_t *vertex = vec_init_ptr(x_p->valuedouble, y_p->valuedouble);
-                list_add(shape, vertex);
+/**
+ * Gets the parsed form of a level file, loading it the first time it is asked for.
+ */
+const level_t *get_level_prototype(const char *path) {
+    level_prototype_t *prototype = find_level_prototype(path);
+    if (prototype == NULL) {
+        prototype = keep_level_prototype(path, level_load(path));
+    }
+    return prototype->level;
+}
+
+void add_level_prototype(const char *path, level_t *level) {
+    level_prototype_t *prototype = find_level_prototype(path);
+    if (prototype == NULL) {
+        keep_level_prototype(path, level);
+    }
+    else if (prototype->level == NULL) {
+        // An earlier load failed; the file may have been fixed since
+        prototype->level = level;
+    }
+    else if (level != NULL) {
+        level_free(level);
+    }
+}
+
+void free_level_prototypes(void) {
+    if (level_prototypes != NULL) {
+        list_free(level_prototypes);
+        level_prototypes = NULL;
+    }
+}
+
+void generate_level(scene_t *scene, body_t *ball, char* level_path) {
+    const level_t *level = get_level_prototype(level_path);
+    if (level == NULL) {
+        return;
+    }
+
+    set_frame(scene, ball, level->bounds);
+
+    for (size_t i = 0; i < level->object_count; i++) {
+        const level_object_t *object = &level->objects[i];
+        switch (object->type) {
+            case LEVEL_BALL:
+                body_set_centroid(ball, object->position);
+                break;
+            case LEVEL_HOLE: {
+                list_t *hole_elements = create_golf_hole(HOLE_RADIUS, rgb_color_gray(), INFINITY);
+                body_t *hole_bound = list_get(hole_elements, 0);
+                body_set_centroid(hole_bound, object->position);
+                create_collision(scene, ball, hole_bound, level_end, scene, NULL);
+                for (size_t j = 0; j < list_size(hole_elements); j++) {
+                    scene_add_body(scene, list_get(hole_elements, j));
+                }
+                list_free(hole_elements);
+                break;
             }
-        }
-        // BALL, GRASS, CIRCLE_GRASS, POWER, WATER, SAND, HOLE, TELEPORT_IN, TELEPORT_OUT
-        if(strcmp(type, "BALL") == 0) {
-            body_set_centroid(ball, vec_init(pos_x, pos_y));
-        }
-        else if(strcmp(type, "HOLE") == 0) {
-            list_t *hole_elements = create_golf_hole(HOLE_RADIUS, rgb_color_gray(), INFINITY);
-            body_t *hole_bound = list_get(hole_elements, 0);
-            body_set_centroid(hole_bound, vec_init(pos_x, pos_y));
-            create_collision(scene, ball, hole_bound, level_end, scene, NULL);
-            for (size_t j = 0; j < list_size(hole_elements); j++) {
-                scene_add_body(scene, list_get(hole_elements, j));
+            case LEVEL_GRASS: {
+                polygon_t *shape = level_shape(level, object->shape_first, object->shape_count);
+                body_t *grass = generate_grass(scene, ball, shape);
+                scene_add_body(scene, grass);
+                break;
             }
-            free(hole_elements);
-        }
-        else if(strcmp(type, "GRASS") == 0) {
-            body_t *grass = generate_grass(scene, ball, shape);
-            scene_add_body(scene, grass);
-        }
-        else if(strcmp(type, "CIRCLE_GRASS") == 0) {
-            cJSON *radius_p = cJSON_GetObjectItemCaseSensitive(object, "radius");
-            double radius = radius_p->valuedouble;
-            body_t *grass = generate_grass(scene, ball, create_circle_shape(radius));
-            body_set_centroid(grass, vec_init(pos_x, pos_y));
-            scene_add_body(scene, grass);
-        }
-        else if(strcmp(type, "WATER") == 0) {
-            body_t *water = generate_water(scene, ball, shape);
-            scene_add_body(scene, water);
-        }
-        else if(strcmp(type, "SAND") == 0) {
-            body_t *sand = generate_sand(scene, ball, shape);
-            scene_add_body(scene, sand);
-        }
-        else if(strcmp(type, "POWER") == 0) {
-            body_t* powerup = generate_boost(scene, ball, create_nstar_shape(5, 50.0));
-            body_set_centroid(powerup, vec_init(pos_x, pos_y));
-            scene_add_body(scene, powerup);
-        }
-        else if(strcmp(type, "TELEPORT") == 0) {
-            cJSON *out_p = cJSON_GetObjectItemCaseSensitive(object, "out");
-            cJSON *vertex_p = NULL;
-            list_t *out_shape = list_init(5, free);
-            cJSON_ArrayForEach(vertex_p, out_p)
-            {
-                cJSON *x_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "x");
-                cJSON *y_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "y");
-                vector_t *vertex = vec_init_ptr(x_p->valuedouble, y_p->valuedouble);
-                list_add(out_shape, vertex);
+            case LEVEL_CIRCLE_GRASS: {
+                body_t *grass = generate_grass(scene, ball, create_circle_shape(object->radius));
+                body_set_circle(grass, object->radius);
+                body_set_centroid(grass, object->position);
+                scene_add_body(scene, grass);
+                break;
+            }
+            case LEVEL_WATER: {
+                polygon_t *shape = level_shape(level, object->shape_first, object->shape_count);
+                body_t *water = generate_water(scene, ball, shape);
+                scene_add_body(scene, water);
+                break;
+            }
+            case LEVEL_SAND: {
+                polygon_t *shape = level_shape(level, object->shape_first, object->shape_count);
+                body_t *sand = generate_sand(scene, ball, shape);
+                scene_add_body(scene, sand);
+                break;
+            }
+            case LEVEL_POWER: {
+                body_t* powerup = generate_boost(scene, ball, create_nstar_shape(5, 50.0));
+                body_set_centroid(powerup, object->position);
+                scene_add_removable_body(scene, powerup);
+                break;
+            }
+            case LEVEL_TELEPORT: {
+                polygon_t *shape = level_shape(level, object->shape_first, object->shape_count);
+                polygon_t *out_shape = level_shape(level, object->out_first, object->out_count);
+                body_t *in = generate_portals(scene, ball, shape, out_shape, object->direction);
+                scene_add_body(scene, in);
+                break;
             }
-
-            cJSON *dir_p = cJSON_GetObjectItemCaseSensitive(object, "direction");
-            cJSON *dir_x = cJSON_GetObjectItemCaseSensitive(dir_p, "x");
-            cJSON *dir_y = cJSON_GetObjectItemCaseSensitive(dir_p, "y");
-            vector_t dir = vec_init(dir_x->valuedouble, dir_y->valuedouble);
-
-            body_t *in = generate_portals(scene, ball, shape, out_shape, dir);
-            scene_add_body(scene, in);
         }
     }
-    goto end;
-
-    end:
-        free(data);
-        cJSON_Delete(monitor_json);
+    triangulate_bodies(scene);
 }
 
 void generate_background(scene_t *scene) {
-    char *data = read_file("resources/background.txt");
+    size_t length = 0;
+    char *data = read_file("resources/background.txt", &length);
     const cJSON *objects = NULL;
     const cJSON *object = NULL;
     int status = 0;
-    cJSON *monitor_json = cJSON_Parse(data);
+    cJSON *monitor_json = cJSON_ParseWithLength(data, length);
     if (monitor_json == NULL) {
         const char *error_ptr = cJSON_GetErrorPtr();
         if (error_ptr != NULL)
@@ -293,17 +344,8 @@ void generate_background(scene_t *scene) {
     cJSON_ArrayForEach(object, objects) {
         cJSON *type_p = cJSON_GetObjectItemCaseSensitive(object, "type");
         char* type = type_p->valuestring;
-        list_t *shape = list_init(5, free);
         cJSON *shape_p = cJSON_GetObjectItemCaseSensitive(object, "shape");
-        cJSON *vertex_p = NULL;
-        shape = list_init(5, free);
-        cJSON_ArrayForEach(vertex_p, shape_p)
-        {
-            cJSON *x_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "x");
-            cJSON *y_p = cJSON_GetObjectItemCaseSensitive(vertex_p, "y");
-            vector_t *vertex = vec_init_ptr(x_p->valuedouble, y_p->valuedouble);
-            list_add(shape, vertex);
-        }
+        polygon_t *shape = read_shape(shape_p);
         rgb_color_t color = rgb_color_init(0, 0, 0);
         if(strcmp(type, "SKY") == 0) {
             color = SKY_COLOR;
@@ -317,6 +359,7 @@ void generate_background(scene_t *scene) {
         body_t *cbody = body_init_with_info(shape, INFINITY, color, make_type_info(BACKGROUND), free);
         scene_add_background_element(scene, cbody);
     }
+    triangulate_bodies(scene);
 
     end:
         free(data);
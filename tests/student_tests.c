@@ -5,20 +5,12 @@
 #include "../include/forces.h"
 #include "../include/test_util.h"
 
-list_t *make_shape() {
-    list_t *shape = list_init(4, free);
-    vector_t *v = malloc(sizeof(vector_t));
-    *v = (vector_t){-1, -1};
-    list_add(shape, v);
-    v = malloc(sizeof(vector_t));
-    *v = (vector_t){+1, -1};
-    list_add(shape, v);
-    v = malloc(sizeof(vector_t));
-    *v = (vector_t){+1, +1};
-    list_add(shape, v);
-    v = malloc(sizeof(vector_t));
-    *v = (vector_t){-1, +1};
-    list_add(shape, v);
+polygon_t *make_shape() {
+    polygon_t *shape = polygon_init(4);
+    polygon_add(shape, (vector_t){-1, -1});
+    polygon_add(shape, (vector_t){+1, -1});
+    polygon_add(shape, (vector_t){+1, +1});
+    polygon_add(shape, (vector_t){-1, +1});
     return shape;
 }
 
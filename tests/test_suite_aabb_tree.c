@@ -0,0 +1,168 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/aabb_tree.h"
+#include "../include/test_util.h"
+
+const size_t NUM_BOXES = 200;
+
+void test_query() {
+    aabb_tree_t *tree = aabb_tree_init(0);
+    int a, b;
+    aabb_tree_insert(tree, &a, (vector_t){0, 0}, (vector_t){5, 5});
+    aabb_tree_insert(tree, &b, (vector_t){100, 100}, (vector_t){105, 105});
+    assert(aabb_tree_size(tree) == 2);
+
+    list_t *results = list_init(2, NULL);
+    aabb_tree_query(tree, (vector_t){4, 4}, (vector_t){6, 6}, results);
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == &a);
+
+    list_clear(results);
+    aabb_tree_query(tree, (vector_t){6, 6}, (vector_t){8, 8}, results);
+    assert(list_size(results) == 0);
+
+    list_free(results);
+    aabb_tree_free(tree);
+}
+
+void test_move_and_remove() {
+    aabb_tree_t *tree = aabb_tree_init(2);
+    int a, b;
+    size_t id_a = aabb_tree_insert(tree, &a, (vector_t){0, 0}, (vector_t){5, 5});
+    size_t id_b = aabb_tree_insert(tree, &b, (vector_t){20, 20}, (vector_t){25, 25});
+    // Small moves stay inside the fat box
+    assert(!aabb_tree_move(tree, id_a, (vector_t){1, 1}, (vector_t){6, 6}));
+    assert(aabb_tree_move(tree, id_a, (vector_t){50, 50}, (vector_t){55, 55}));
+
+    list_t *results = list_init(2, NULL);
+    aabb_tree_query(tree, (vector_t){0, 0}, (vector_t){10, 10}, results);
+    assert(list_size(results) == 0);
+    aabb_tree_query(tree, (vector_t){50, 50}, (vector_t){51, 51}, results);
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == &a);
+
+    aabb_tree_remove(tree, id_b);
+    assert(aabb_tree_size(tree) == 1);
+    list_clear(results);
+    aabb_tree_query(tree, (vector_t){0, 0}, (vector_t){100, 100}, results);
+    assert(list_size(results) == 1);
+
+    list_free(results);
+    aabb_tree_free(tree);
+}
+
+void test_clear() {
+    aabb_tree_t *tree = aabb_tree_init(0);
+    int items[NUM_BOXES];
+    for (size_t i = 0; i < NUM_BOXES; i++) {
+        aabb_tree_insert(tree, &items[i], (vector_t){i, 0}, (vector_t){i + 1, 1});
+    }
+    aabb_tree_clear(tree);
+    assert(aabb_tree_size(tree) == 0);
+
+    list_t *results = list_init(2, NULL);
+    aabb_tree_query(tree, (vector_t){0, 0}, (vector_t){NUM_BOXES, 1}, results);
+    assert(list_size(results) == 0);
+
+    // Still usable after being cleared
+    aabb_tree_insert(tree, &items[0], (vector_t){0, 0}, (vector_t){1, 1});
+    aabb_tree_query(tree, (vector_t){0, 0}, (vector_t){NUM_BOXES, 1}, results);
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == &items[0]);
+
+    list_free(results);
+    aabb_tree_free(tree);
+}
+
+typedef struct box {
+    vector_t min;
+    vector_t max;
+    size_t id;
+    bool removed;
+    size_t pairs;
+} box_t;
+
+void count_pair(box_t *box1, box_t *box2, void *aux) {
+    assert(box1 != box2);
+    box1->pairs++;
+    box2->pairs++;
+    (*(size_t *) aux)++;
+}
+
+void random_box(box_t *box) {
+    box->min = (vector_t){rand() % 1000, rand() % 1000};
+    box->max = vec_add(box->min, (vector_t){1 + rand() % 50, 1 + rand() % 50});
+}
+
+bool overlaps(box_t *box1, box_t *box2) {
+    return box1->min.x <= box2->max.x && box2->min.x <= box1->max.x &&
+           box1->min.y <= box2->max.y && box2->min.y <= box1->max.y;
+}
+
+// Pair query must agree with checking every pair, through inserts, moves and removes
+void test_pairs_match_brute_force() {
+    srand(7);
+    aabb_tree_t *tree = aabb_tree_init(0);
+    box_t *boxes = malloc(sizeof(box_t) * NUM_BOXES);
+    for (size_t i = 0; i < NUM_BOXES; i++) {
+        random_box(&boxes[i]);
+        boxes[i].removed = false;
+        boxes[i].id = aabb_tree_insert(tree, &boxes[i], boxes[i].min, boxes[i].max);
+    }
+    for (size_t i = 0; i < NUM_BOXES; i += 3) {
+        random_box(&boxes[i]);
+        aabb_tree_move(tree, boxes[i].id, boxes[i].min, boxes[i].max);
+    }
+    for (size_t i = 0; i < NUM_BOXES; i += 5) {
+        boxes[i].removed = true;
+        aabb_tree_remove(tree, boxes[i].id);
+    }
+
+    size_t expected = 0;
+    for (size_t i = 0; i < NUM_BOXES; i++) {
+        boxes[i].pairs = 0;
+        for (size_t j = 0; j < NUM_BOXES; j++) {
+            if (i != j && !boxes[i].removed && !boxes[j].removed && overlaps(&boxes[i], &boxes[j])) {
+                boxes[i].pairs++;
+            }
+        }
+        expected += boxes[i].pairs;
+    }
+    size_t found = 0;
+    for (size_t i = 0; i < NUM_BOXES; i++) {
+        boxes[i].pairs = 0;
+    }
+    aabb_tree_query_pairs(tree, (aabb_pair_handler_t) count_pair, &found);
+    assert(found * 2 == expected);
+    for (size_t i = 0; i < NUM_BOXES; i++) {
+        size_t pairs = boxes[i].pairs;
+        boxes[i].pairs = 0;
+        for (size_t j = 0; j < NUM_BOXES; j++) {
+            if (i != j && !boxes[i].removed && !boxes[j].removed && overlaps(&boxes[i], &boxes[j])) {
+                boxes[i].pairs++;
+            }
+        }
+        assert(pairs == boxes[i].pairs);
+    }
+
+    free(boxes);
+    aabb_tree_free(tree);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+    DO_TEST(test_query)
+    DO_TEST(test_move_and_remove)
+    DO_TEST(test_clear)
+    DO_TEST(test_pairs_match_brute_force)
+    puts("aabb_tree_tests PASS");
+}
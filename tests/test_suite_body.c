@@ -1,4 +1,161 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/body.h"
+#include "../include/test_util.h"
+
+// A 4x2 rectangle around the origin, so it is its own local shape
+const vector_t RECT_VERTICES[] = {{-2, -1}, {2, -1}, {2, 1}, {-2, 1}};
+const size_t RECT_SIZE = sizeof(RECT_VERTICES) / sizeof(RECT_VERTICES[0]);
+
+body_t *make_rect_body(double mass) {
+    polygon_t *shape = polygon_init(RECT_SIZE);
+    for (size_t i = 0; i < RECT_SIZE; i++) {
+        polygon_add(shape, RECT_VERTICES[i]);
+    }
+    return body_init(shape, mass, rgb_color_gray());
+}
+
+/**
+ * Checks that a body's world shape and bounding box are the rectangle
+ * rotated by angle about the origin and then moved to centroid.
+ */
+void assert_placed(body_t *body, vector_t centroid, double angle) {
+    const polygon_t *shape = body_get_shape_view(body);
+    assert(polygon_size(shape) == RECT_SIZE);
+    vector_t min = {INFINITY, INFINITY};
+    vector_t max = {-INFINITY, -INFINITY};
+    for (size_t i = 0; i < RECT_SIZE; i++) {
+        vector_t expected = vec_add(centroid, vec_rotate(RECT_VERTICES[i], angle));
+        assert(vec_isclose(polygon_get(shape, i), expected));
+        min = (vector_t) {fmin(min.x, expected.x), fmin(min.y, expected.y)};
+        max = (vector_t) {fmax(max.x, expected.x), fmax(max.y, expected.y)};
+    }
+    vector_t bounds_min, bounds_max;
+    body_get_bounds(body, &bounds_min, &bounds_max);
+    assert(vec_isclose(bounds_min, min));
+    assert(vec_isclose(bounds_max, max));
+}
+
+void test_shape_follows_centroid() {
+    body_t *body = make_rect_body(1);
+    assert_placed(body, VEC_ZERO, 0);
+    body_set_centroid(body, (vector_t){5, 3});
+    assert_placed(body, (vector_t){5, 3}, 0);
+    // Reading the shape again does not move it further
+    assert_placed(body, (vector_t){5, 3}, 0);
+    body_set_centroid(body, (vector_t){-1, 7});
+    assert_placed(body, (vector_t){-1, 7}, 0);
+    body_free(body);
+}
+
+void test_shape_follows_rotation() {
+    body_t *body = make_rect_body(1);
+    body_set_rotation(body, M_PI / 2);
+    assert_placed(body, VEC_ZERO, M_PI / 2);
+    // Rotation is about the centroid, and absolute
+    body_set_centroid(body, (vector_t){5, 3});
+    body_set_rotation(body, M_PI / 6);
+    assert_placed(body, (vector_t){5, 3}, M_PI / 6);
+    assert(isclose(body_get_rotation(body), M_PI / 6));
+    body_free(body);
+}
+
+void test_shape_follows_translate() {
+    body_t *body = make_rect_body(1);
+    body_set_rotation(body, M_PI / 4);
+    body_translate(body, (vector_t){1, 2});
+    assert_placed(body, (vector_t){1, 2}, M_PI / 4);
+    body_translate(body, (vector_t){-3, 0.5});
+    assert_placed(body, (vector_t){-2, 2.5}, M_PI / 4);
+    body_free(body);
+}
+
+void test_shape_follows_tick() {
+    body_t *body = make_rect_body(2);
+    body_set_centroid(body, (vector_t){1, 1});
+    body_set_velocity(body, (vector_t){2, 0});
+    body_tick(body, 0.5);
+    assert_placed(body, (vector_t){2, 1}, 0);
+    assert(vec_isclose(body_get_previous_centroid(body), (vector_t){1, 1}));
+
+    // Moved at the average of the velocities before and after the force
+    body_add_force(body, (vector_t){0, 8});
+    body_tick(body, 0.5);
+    assert_placed(body, (vector_t){3, 1.5}, 0);
+
+    // At rest, ticking leaves the shape where it is
+    body_set_velocity(body, VEC_ZERO);
+    body_tick(body, 0.5);
+    assert_placed(body, (vector_t){3, 1.5}, 0);
+    body_free(body);
+}
+
+void test_state_round_trip() {
+    body_t *body = make_rect_body(1);
+    body_set_centroid(body, (vector_t){4, 4});
+    body_set_velocity(body, (vector_t){1, -1});
+    body_set_rotation(body, 0.5);
+    body_tick(body, 1);
+    body_state_t state = body_get_state(body);
+
+    body_set_centroid(body, (vector_t){-10, -10});
+    body_set_velocity(body, VEC_ZERO);
+    body_set_rotation(body, 0);
+    body_remove(body);
+    body_set_state(body, state);
+    assert(vec_equal(body_get_centroid(body), (vector_t){5, 3}));
+    assert(vec_equal(body_get_previous_centroid(body), (vector_t){4, 4}));
+    assert(vec_equal(body_get_velocity(body), (vector_t){1, -1}));
+    assert(body_get_rotation(body) == 0.5);
+    assert(!body_is_removed(body));
+    assert_placed(body, (vector_t){5, 3}, 0.5);
+
+    // Forces from before the restore are dropped
+    body_add_force(body, (vector_t){100, 0});
+    body_set_state(body, state);
+    body_tick(body, 1);
+    assert(vec_isclose(body_get_centroid(body), (vector_t){6, 2}));
+    body_free(body);
+}
+
+void test_set_state_moves_anchors() {
+    body_t *body = make_rect_body(1);
+    body_t *anchored = make_rect_body(1);
+    body_set_centroid(anchored, (vector_t){0, 3});
+    body_add_anchor(body, anchored);
+
+    body_state_t state = body_get_state(body);
+    state.centroid = (vector_t){4, 5};
+    body_set_state(body, state);
+    assert(vec_equal(body_get_centroid(anchored), (vector_t){4, 8}));
+    assert_placed(anchored, (vector_t){4, 8}, 0);
+
+    state.centroid = (vector_t){1, 1};
+    body_set_state(body, state);
+    assert(vec_equal(body_get_centroid(anchored), (vector_t){1, 4}));
+    assert_placed(anchored, (vector_t){1, 4}, 0);
+
+    // The anchored body is not freed with the body it is anchored to
+    body_free(body);
+    body_free(anchored);
+}
 
 int main(int argc, char *argv[]) {
-    return 0;
-}
\ No newline at end of file
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+    DO_TEST(test_shape_follows_centroid)
+    DO_TEST(test_shape_follows_rotation)
+    DO_TEST(test_shape_follows_translate)
+    DO_TEST(test_shape_follows_tick)
+    DO_TEST(test_state_round_trip)
+    DO_TEST(test_set_state_moves_anchors)
+    puts("body_tests PASS");
+}
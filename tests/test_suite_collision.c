@@ -62,6 +62,76 @@ void test_collision() {
     // assert(!find_collision(shape1, shape5)); // Square and non-overlapping triangle
 }
 
+polygon_t *make_rectangle(vector_t min, vector_t max) {
+    polygon_t *rect = polygon_init(4);
+    polygon_add(rect, min);
+    polygon_add(rect, (vector_t){max.x, min.y});
+    polygon_add(rect, max);
+    polygon_add(rect, (vector_t){min.x, max.y});
+    return rect;
+}
+
+void test_collision_axis() {
+    polygon_t *shape1 = make_rectangle((vector_t){0, 0}, (vector_t){10, 10});
+    // Overlaps shape1 by 1 in x and 8 in y, so it is pushed out along x
+    polygon_t *shape2 = make_rectangle((vector_t){9, 2}, (vector_t){20, 20});
+    collision_info_t info = find_collision(shape1, shape2);
+    assert(info.collided);
+    assert(isclose(fabs(info.axis.x), 1));
+    assert(isclose(info.axis.y, 0));
+    polygon_free(shape1);
+    polygon_free(shape2);
+}
+
+void test_no_collision() {
+    polygon_t *shape1 = make_rectangle((vector_t){0, 0}, (vector_t){10, 10});
+    polygon_t *shape2 = make_rectangle((vector_t){11, 0}, (vector_t){20, 10});
+    assert(!find_collision(shape1, shape2).collided);
+    assert(!find_collision(shape2, shape1).collided);
+    polygon_free(shape1);
+    polygon_free(shape2);
+}
+
+void test_circle_collision() {
+    collision_info_t info = find_circle_collision((vector_t){0, 0}, 1, (vector_t){3, 4}, 4.5);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){0.6, 0.8}));
+    assert(!find_circle_collision((vector_t){0, 0}, 1, (vector_t){3, 4}, 3.5).collided);
+}
+
+void test_circle_polygon_collision() {
+    polygon_t *square = make_rectangle((vector_t){0, 0}, (vector_t){10, 10});
+    // Near the corner, the axis points at the corner rather than along an edge normal
+    collision_info_t info = find_circle_polygon_collision((vector_t){-1, -1}, 2, square);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, vec_normalize((vector_t){1, 1})));
+    assert(!find_circle_polygon_collision((vector_t){-1, -1}, 1, square).collided);
+
+    // Overlapping an edge
+    info = find_circle_polygon_collision((vector_t){5, 11}, 2, square);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){0, -1}));
+
+    // Center inside, nearest the top edge: still points from the circle into the polygon
+    info = find_circle_polygon_collision((vector_t){5, 9}, 2, square);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){0, -1}));
+
+    // Center exactly on the top edge, with the vertices in either order
+    info = find_circle_polygon_collision((vector_t){5, 10}, 2, square);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){0, -1}));
+    polygon_t *clockwise = polygon_init(4);
+    for (size_t i = polygon_size(square); i > 0; i--) {
+        polygon_add(clockwise, polygon_vertices(square)[i - 1]);
+    }
+    info = find_circle_polygon_collision((vector_t){5, 10}, 2, clockwise);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){0, -1}));
+    polygon_free(clockwise);
+    polygon_free(square);
+}
+
 int main(int argc, char *argv[]) {
     // Run all tests if there are no command-line arguments
     bool all_tests = argc == 1;
@@ -71,5 +141,9 @@ int main(int argc, char *argv[]) {
         read_testname(argv[1], testname, sizeof(testname));
     }
     DO_TEST(test_collision)
+    DO_TEST(test_collision_axis)
+    DO_TEST(test_no_collision)
+    DO_TEST(test_circle_collision)
+    DO_TEST(test_circle_polygon_collision)
     puts("collision_tests PASS");
 }
\ No newline at end of file
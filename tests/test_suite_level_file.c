@@ -0,0 +1,156 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../include/level_file.h"
+#include "../include/test_util.h"
+
+const char LEVEL_JSON[] =
+    "{\"name\": \"Test\", \"bounds\": {\"width\": 2000.0, \"height\": 1000.0},"
+    " \"objects\": ["
+    "  {\"type\": \"BALL\", \"pos_x\": 50.0, \"pos_y\": 1000.0},"
+    "  {\"type\": \"GRASS\", \"pos_x\": 0, \"pos_y\": 0,"
+    "   \"shape\": [{\"x\": 0, \"y\": 0}, {\"x\": 10, \"y\": 0}, {\"x\": 10, \"y\": 5}]},"
+    "  {\"type\": \"CIRCLE_GRASS\", \"pos_x\": 300, \"pos_y\": 200, \"radius\": 40},"
+    "  {\"type\": \"TELEPORT\", \"pos_x\": 0, \"pos_y\": 0,"
+    "   \"shape\": [{\"x\": 1, \"y\": 1}, {\"x\": 2, \"y\": 1}, {\"x\": 2, \"y\": 2}],"
+    "   \"out\": [{\"x\": 5, \"y\": 5}, {\"x\": 6, \"y\": 5}, {\"x\": 6, \"y\": 6}, {\"x\": 5, \"y\": 6}],"
+    "   \"direction\": {\"x\": 0, \"y\": 1}}"
+    " ]}";
+
+level_t *parse(const char *json) {
+    return level_parse_json(json, strlen(json));
+}
+
+void test_parse_json() {
+    level_t *level = parse(LEVEL_JSON);
+    assert(level != NULL);
+    assert(vec_equal(level->bounds, (vector_t){2000, 1000}));
+    assert(level->object_count == 4);
+    assert(level->vertex_count == 10);
+
+    assert(level->objects[0].type == LEVEL_BALL);
+    assert(vec_equal(level->objects[0].position, (vector_t){50, 1000}));
+    assert(level->objects[0].shape_count == 0);
+
+    assert(level->objects[1].type == LEVEL_GRASS);
+    assert(level->objects[1].shape_count == 3);
+    assert(vec_equal(level->vertices[level->objects[1].shape_first + 2], (vector_t){10, 5}));
+
+    assert(level->objects[2].type == LEVEL_CIRCLE_GRASS);
+    assert(level->objects[2].radius == 40);
+
+    level_object_t *teleport = &level->objects[3];
+    assert(teleport->type == LEVEL_TELEPORT);
+    assert(teleport->shape_count == 3);
+    assert(teleport->out_count == 4);
+    assert(vec_equal(level->vertices[teleport->out_first], (vector_t){5, 5}));
+    assert(vec_equal(teleport->direction, (vector_t){0, 1}));
+    level_free(level);
+}
+
+void test_compile_round_trip() {
+    level_t *level = parse(LEVEL_JSON);
+    size_t size = 0;
+    char *data = level_compile(level, &size);
+    assert(data != NULL);
+    // Smaller than the JSON it came from
+    assert(size < strlen(LEVEL_JSON));
+
+    level_t *loaded = level_load_compiled(data, size);
+    assert(loaded != NULL);
+    // The tables are used in place, not copied
+    assert((char *) loaded->objects > data && (char *) loaded->vertices < data + size);
+    assert(vec_equal(loaded->bounds, level->bounds));
+    assert(loaded->object_count == level->object_count);
+    assert(loaded->vertex_count == level->vertex_count);
+    assert(memcmp(loaded->objects, level->objects, sizeof(level_object_t) * level->object_count) == 0);
+    assert(memcmp(loaded->vertices, level->vertices, sizeof(vector_t) * level->vertex_count) == 0);
+    level_free(loaded);
+    level_free(level);
+}
+
+void test_rejects_invalid_json() {
+    // Missing position
+    assert(parse("{\"bounds\": {\"width\": 1, \"height\": 1},"
+                 " \"objects\": [{\"type\": \"BALL\", \"pos_x\": 1}]}") == NULL);
+    // Unknown type
+    assert(parse("{\"bounds\": {\"width\": 1, \"height\": 1},"
+                 " \"objects\": [{\"type\": \"LAVA\", \"pos_x\": 1, \"pos_y\": 1}]}") == NULL);
+    // A circle without a usable radius
+    assert(parse("{\"bounds\": {\"width\": 1, \"height\": 1},"
+                 " \"objects\": [{\"type\": \"CIRCLE_GRASS\", \"pos_x\": 1, \"pos_y\": 1,"
+                 " \"radius\": 0}]}") == NULL);
+    assert(parse("{\"bounds\": {\"width\": 1, \"height\": 1},"
+                 " \"objects\": [{\"type\": \"CIRCLE_GRASS\", \"pos_x\": 1, \"pos_y\": 1,"
+                 " \"radius\": 1e999}]}") == NULL);
+    // Too few vertices
+    assert(parse("{\"bounds\": {\"width\": 1, \"height\": 1},"
+                 " \"objects\": [{\"type\": \"SAND\", \"pos_x\": 1, \"pos_y\": 1,"
+                 " \"shape\": [{\"x\": 0, \"y\": 0}, {\"x\": 1, \"y\": 0}]}]}") == NULL);
+    // No bounds
+    assert(parse("{\"objects\": []}") == NULL);
+    // Not JSON
+    assert(parse("{\"bounds\": ") == NULL);
+}
+
+void test_rejects_invalid_compiled() {
+    level_t *level = parse(LEVEL_JSON);
+    size_t size = 0;
+
+    // Truncated
+    char *data = level_compile(level, &size);
+    assert(level_load_compiled(data, size - 8) == NULL);
+
+    // Wrong magic
+    data = level_compile(level, &size);
+    data[0] = 'X';
+    assert(level_load_compiled(data, size) == NULL);
+
+    // A shape past the end of the vertices
+    data = level_compile(level, &size);
+    level_t *loaded = level_load_compiled(data, size);
+    assert(loaded != NULL);
+    loaded->objects[1].shape_first = loaded->vertex_count - 1;
+    char *corrupt = malloc(size);
+    memcpy(corrupt, data, size);
+    assert(level_load_compiled(corrupt, size) == NULL);
+    loaded->objects[1].shape_first = level->objects[1].shape_first;
+
+    // A shape on an object that is only placed at its position
+    loaded->objects[0].shape_count = 3;
+    corrupt = malloc(size);
+    memcpy(corrupt, data, size);
+    assert(level_load_compiled(corrupt, size) == NULL);
+    loaded->objects[0].shape_count = 0;
+
+    // A circle with no radius
+    loaded->objects[2].radius = 0;
+    corrupt = malloc(size);
+    memcpy(corrupt, data, size);
+    assert(level_load_compiled(corrupt, size) == NULL);
+    loaded->objects[2].radius = NAN;
+    corrupt = malloc(size);
+    memcpy(corrupt, data, size);
+    assert(level_load_compiled(corrupt, size) == NULL);
+    level_free(loaded);
+
+    level_free(level);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+    DO_TEST(test_parse_json)
+    DO_TEST(test_compile_round_trip)
+    DO_TEST(test_rejects_invalid_json)
+    DO_TEST(test_rejects_invalid_compiled)
+    puts("level_file_tests PASS");
+}
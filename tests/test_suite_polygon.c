@@ -1,4 +1,117 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/polygon.h"
+#include "../include/test_util.h"
+
+// Square with corners (0, 0) and (2, 2)
+polygon_t *make_square() {
+    polygon_t *square = polygon_init(4);
+    polygon_add(square, (vector_t){0, 0});
+    polygon_add(square, (vector_t){2, 0});
+    polygon_add(square, (vector_t){2, 2});
+    polygon_add(square, (vector_t){0, 2});
+    return square;
+}
+
+void test_square_area_centroid() {
+    polygon_t *square = make_square();
+    assert(polygon_size(square) == 4);
+    assert(isclose(polygon_area(square), 4));
+    assert(vec_isclose(polygon_centroid(square), (vector_t){1, 1}));
+    polygon_free(square);
+}
+
+void test_vertices_contiguous() {
+    polygon_t *square = make_square();
+    const vector_t *vertices = polygon_vertices(square);
+    for (size_t i = 0; i < polygon_size(square); i++) {
+        assert(vec_equal(vertices[i], polygon_get(square, i)));
+    }
+    polygon_set(square, 1, (vector_t){3, 0});
+    assert(vec_equal(vertices[1], (vector_t){3, 0}));
+    polygon_free(square);
+}
+
+void test_translate_rotate_copy() {
+    polygon_t *square = make_square();
+    polygon_t *copy = polygon_copy(square);
+    polygon_translate(square, (vector_t){1, 1});
+    assert(vec_isclose(polygon_centroid(square), (vector_t){2, 2}));
+    polygon_rotate(square, M_PI / 2, (vector_t){2, 2});
+    assert(vec_isclose(polygon_get(square, 0), (vector_t){3, 1}));
+    // The copy owns its own vertices
+    assert(vec_isclose(polygon_centroid(copy), (vector_t){1, 1}));
+    polygon_free(square);
+    polygon_free(copy);
+}
+
+void test_transform() {
+    polygon_t *square = make_square();
+    polygon_t *world = polygon_init(4);
+    polygon_transform(world, square, M_PI / 2, (vector_t){10, 0});
+    assert(polygon_size(world) == 4);
+    assert(vec_isclose(polygon_get(world, 1), (vector_t){10, 2}));
+    assert(vec_isclose(polygon_get(world, 2), (vector_t){8, 2}));
+    // The source is untouched
+    assert(vec_equal(polygon_get(square, 1), (vector_t){2, 0}));
+    polygon_transform(world, square, 0, (vector_t){1, 1});
+    assert(vec_equal(polygon_get(world, 2), (vector_t){3, 3}));
+    polygon_free(square);
+    polygon_free(world);
+}
+
+// Sums the areas of the triangles, checking each turns the same way as the polygon
+double triangulated_area(polygon_t *polygon, double direction) {
+    size_t n = polygon_size(polygon);
+    size_t *triangles = malloc(sizeof(size_t) * 3 * (n - 2));
+    assert(polygon_triangulate(polygon, triangles) == n - 2);
+    double area = 0;
+    for (size_t i = 0; i < n - 2; i++) {
+        vector_t a = polygon_get(polygon, triangles[3 * i]);
+        vector_t b = polygon_get(polygon, triangles[3 * i + 1]);
+        vector_t c = polygon_get(polygon, triangles[3 * i + 2]);
+        double twice_area = direction * vec_cross(vec_subtract(b, a), vec_subtract(c, a));
+        assert(twice_area >= 0);
+        area += twice_area / 2;
+    }
+    free(triangles);
+    return area;
+}
+
+void test_triangulate() {
+    polygon_t *square = make_square();
+    assert(isclose(triangulated_area(square, 1), 4));
+    polygon_free(square);
+
+    // An L shape, whose reflex corner at (1, 1) cannot be clipped
+    vector_t l_shape[] = {{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}};
+    polygon_t *ccw = polygon_init(6);
+    polygon_t *cw = polygon_init(6);
+    for (size_t i = 0; i < 6; i++) {
+        polygon_add(ccw, l_shape[i]);
+        polygon_add(cw, l_shape[5 - i]);
+    }
+    assert(isclose(triangulated_area(ccw, 1), 3));
+    assert(isclose(triangulated_area(cw, -1), 3));
+    polygon_free(ccw);
+    polygon_free(cw);
+}
 
 int main(int argc, char *argv[]) {
-    return 0;
-}
\ No newline at end of file
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+    DO_TEST(test_square_area_centroid)
+    DO_TEST(test_vertices_contiguous)
+    DO_TEST(test_translate_rotate_copy)
+    DO_TEST(test_transform)
+    DO_TEST(test_triangulate)
+    puts("polygon_tests PASS");
+}
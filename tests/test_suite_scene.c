@@ -1,4 +1,195 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/scene.h"
+#include "../include/forces.h"
+#include "../include/level_handlers.h"
+#include "../include/test_util.h"
+
+const double DT = 0.1;
+const vector_t FALL_VELOCITY = {0, -10};
+
+polygon_t *make_box(vector_t min, vector_t max) {
+    polygon_t *box = polygon_init(4);
+    polygon_add(box, min);
+    polygon_add(box, (vector_t){max.x, min.y});
+    polygon_add(box, max);
+    polygon_add(box, (vector_t){min.x, max.y});
+    return box;
+}
+
+void count_hit(body_t *body1, body_t *body2, vector_t axis, size_t *hits) {
+    (*hits)++;
+}
+
+/**
+ * Makes a 2x2 ball at (0, 10), falling towards the top of a static slab
+ * at y = 0, with a collision between them that counts its handler calls.
+ */
+body_t *make_falling_ball(scene_t *scene, size_t *hits) {
+    body_t *ball = body_init_with_info(make_box((vector_t){-1, -1}, (vector_t){1, 1}), 1,
+                                       rgb_color_gray(), make_type_info(BALL), free);
+    body_set_centroid(ball, (vector_t){0, 10});
+    body_set_velocity(ball, FALL_VELOCITY);
+    scene_add_body(scene, ball);
+    // The ground's centroid is the body's origin, so its shape is centered on it
+    body_t *ground = body_init_with_info(make_box((vector_t){-10, -1}, (vector_t){10, 1}), INFINITY,
+                                         rgb_color_gray(), make_type_info(HOLE), free);
+    body_set_centroid(ground, (vector_t){0, -1});
+    scene_add_body(scene, ground);
+    create_collision(scene, ball, ground, (collision_handler_t) count_hit, hits, NULL);
+    scene_index_static_bodies(scene);
+    return ball;
+}
+
+collision_aux_t *first_collision(scene_t *scene) {
+    list_t *force_bundles = scene_get_force_bundles(scene);
+    for (size_t i = 0; i < list_size(force_bundles); i++) {
+        force_bundle_t *force_bundle = list_get(force_bundles, i);
+        if (get_force_bundle_forcer(force_bundle) == (force_creator_t) collision_force_creator) {
+            return get_force_bundle_aux(force_bundle);
+        }
+    }
+    assert(false);
+    return NULL;
+}
+
+/**
+ * Ticks until the collision's bodies touch, and returns the number of ticks.
+ */
+size_t tick_until_collided(scene_t *scene) {
+    size_t ticks = 0;
+    while (!collision_aux_get_collided(first_collision(scene))) {
+        scene_tick(scene, DT);
+        ticks++;
+        assert(ticks < 100);
+    }
+    return ticks;
+}
+
+void test_restore() {
+    scene_t *scene = scene_init();
+    size_t hits = 0;
+    body_t *ball = make_falling_ball(scene, &hits);
+    scene_set_points(scene, 3);
+    scene_set_state(scene, 0);
+    scene_snapshot_t *snapshot = scene_snapshot(scene);
+
+    size_t ticks = tick_until_collided(scene);
+    assert(hits == 1);
+    assert(!vec_isclose(body_get_centroid(ball), (vector_t){0, 10}));
+    assert(!vec_isclose(scene_get_view_offset(scene, SCENE_LAYER_BODIES, 1), VEC_ZERO));
+    scene_add_point(scene);
+    scene_set_state(scene, -1);
+
+    assert(scene_restore(scene, snapshot));
+    assert(vec_equal(body_get_centroid(ball), (vector_t){0, 10}));
+    assert(vec_equal(body_get_velocity(ball), FALL_VELOCITY));
+    assert(scene_get_points(scene) == 3);
+    assert(scene_get_state(scene) == 0);
+    assert(vec_equal(scene_get_view_offset(scene, SCENE_LAYER_BODIES, 0), VEC_ZERO));
+    assert(vec_equal(scene_get_view_offset(scene, SCENE_LAYER_BODIES, 1), VEC_ZERO));
+    assert(!collision_aux_get_collided(first_collision(scene)));
+
+    // The replay lands the same way, and the handler runs again
+    assert(tick_until_collided(scene) == ticks);
+    assert(hits == 2);
+
+    // A snapshot taken while touching restores the collided flag
+    free(snapshot);
+    snapshot = scene_snapshot(scene);
+    vector_t touching = body_get_centroid(ball);
+    body_set_velocity(ball, (vector_t){0, 100});
+    while (collision_aux_get_collided(first_collision(scene))) {
+        scene_tick(scene, DT);
+    }
+    assert(scene_restore(scene, snapshot));
+    assert(vec_equal(body_get_centroid(ball), touching));
+    assert(collision_aux_get_collided(first_collision(scene)));
+    // Still touching, so the handler is not run again
+    scene_tick(scene, DT);
+    assert(hits == 2);
+
+    free(snapshot);
+    scene_free(scene);
+}
+
+void test_restore_refused() {
+    scene_t *scene = scene_init();
+    size_t hits = 0;
+    body_t *ball = make_falling_ball(scene, &hits);
+    scene_set_state(scene, 0);
+    scene_snapshot_t *snapshot = scene_snapshot(scene);
+
+    // Adding a body
+    scene_tick(scene, DT);
+    vector_t centroid = body_get_centroid(ball);
+    scene_add_body(scene, body_init(make_box((vector_t){-1, -1}, (vector_t){1, 1}), INFINITY, rgb_color_gray()));
+    scene_add_point(scene);
+    assert(!scene_restore(scene, snapshot));
+    assert(vec_equal(body_get_centroid(ball), centroid));
+    assert(scene_get_points(scene) == 1);
+    free(snapshot);
+
+    // Removing a body
+    snapshot = scene_snapshot(scene);
+    body_remove(scene_get_body(scene, scene_bodies(scene) - 1));
+    scene_tick(scene, DT);
+    centroid = body_get_centroid(ball);
+    assert(!scene_restore(scene, snapshot));
+    assert(vec_equal(body_get_centroid(ball), centroid));
+    free(snapshot);
+
+    scene_free(scene);
+}
+
+void test_snapshot_size() {
+    scene_t *scene = scene_init();
+    polygon_t *shape = make_box((vector_t){-1, -1}, (vector_t){1, 1});
+    body_t *ball = body_init_with_info(polygon_copy(shape), 1, rgb_color_gray(), make_type_info(BALL), free);
+    scene_add_body(scene, ball);
+    scene_snapshot_t *snapshot = scene_snapshot(scene);
+    size_t header = scene_snapshot_size(snapshot);
+    free(snapshot);
+    // One moving body, with its index
+    size_t moving = sizeof(size_t) + sizeof(body_state_t);
+
+    // Static bodies are not saved
+    body_t *wall = body_init_with_info(polygon_copy(shape), INFINITY, rgb_color_gray(), make_type_info(HOLE), free);
+    scene_add_body(scene, wall);
+    snapshot = scene_snapshot(scene);
+    assert(scene_snapshot_size(snapshot) == header);
+    free(snapshot);
+
+    scene_add_body(scene, body_init(polygon_copy(shape), 1, rgb_color_gray()));
+    snapshot = scene_snapshot(scene);
+    assert(scene_snapshot_size(snapshot) == header + moving);
+    free(snapshot);
+
+    // A bit per collision, rounded up to whole bytes
+    size_t hits = 0;
+    for (size_t collisions = 1; collisions <= 9; collisions++) {
+        create_collision(scene, ball, wall, (collision_handler_t) count_hit, &hits, NULL);
+        snapshot = scene_snapshot(scene);
+        assert(scene_snapshot_size(snapshot) == header + moving + (collisions + 7) / 8);
+        free(snapshot);
+    }
+    polygon_free(shape);
+    scene_free(scene);
+}
 
 int main(int argc, char *argv[]) {
-    return 0;
-}
\ No newline at end of file
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+    DO_TEST(test_restore)
+    DO_TEST(test_restore_refused)
+    DO_TEST(test_snapshot_size)
+    puts("scene_tests PASS");
+}
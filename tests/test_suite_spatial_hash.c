@@ -0,0 +1,100 @@
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "../include/spatial_hash.h"
+#include "../include/test_util.h"
+
+void test_query_finds_overlapping() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    int a, b;
+    spatial_hash_insert(hash, &a, (vector_t){0, 0}, (vector_t){5, 5});
+    spatial_hash_insert(hash, &b, (vector_t){100, 100}, (vector_t){105, 105});
+    assert(spatial_hash_size(hash) == 2);
+
+    list_t *results = list_init(2, NULL);
+    spatial_hash_query(hash, (vector_t){4, 4}, (vector_t){6, 6}, results);
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == &a);
+
+    // Same cell as a, but the boxes do not overlap
+    list_clear(results);
+    spatial_hash_query(hash, (vector_t){6, 6}, (vector_t){8, 8}, results);
+    assert(list_size(results) == 0);
+
+    list_free(results);
+    spatial_hash_free(hash);
+}
+
+void test_query_reports_once() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    int a;
+    // Covers 5 x 5 cells, including negative coordinates
+    spatial_hash_insert(hash, &a, (vector_t){-20, -20}, (vector_t){25, 25});
+
+    list_t *results = list_init(2, NULL);
+    spatial_hash_query(hash, (vector_t){-15, -15}, (vector_t){15, 15}, results);
+    assert(list_size(results) == 1);
+    list_clear(results);
+    spatial_hash_query(hash, (vector_t){-15, -15}, (vector_t){15, 15}, results);
+    assert(list_size(results) == 1);
+
+    list_free(results);
+    spatial_hash_free(hash);
+}
+
+void test_remove() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    int a, b;
+    spatial_hash_insert(hash, &a, (vector_t){0, 0}, (vector_t){15, 15});
+    spatial_hash_insert(hash, &b, (vector_t){5, 5}, (vector_t){25, 25});
+    spatial_hash_remove(hash, &a);
+    // Removing an item that is not there does nothing
+    spatial_hash_remove(hash, &a);
+    assert(spatial_hash_size(hash) == 1);
+
+    list_t *results = list_init(2, NULL);
+    spatial_hash_query(hash, (vector_t){0, 0}, (vector_t){30, 30}, results);
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == &b);
+
+    list_free(results);
+    spatial_hash_free(hash);
+}
+
+void test_clear() {
+    spatial_hash_t *hash = spatial_hash_init(10);
+    int a, b;
+    spatial_hash_insert(hash, &a, (vector_t){0, 0}, (vector_t){15, 15});
+    spatial_hash_clear(hash);
+    assert(spatial_hash_size(hash) == 0);
+
+    list_t *results = list_init(2, NULL);
+    spatial_hash_query(hash, (vector_t){0, 0}, (vector_t){30, 30}, results);
+    assert(list_size(results) == 0);
+
+    // Still usable after being cleared
+    spatial_hash_insert(hash, &b, (vector_t){5, 5}, (vector_t){8, 8});
+    spatial_hash_query(hash, (vector_t){0, 0}, (vector_t){30, 30}, results);
+    assert(list_size(results) == 1);
+    assert(list_get(results, 0) == &b);
+
+    list_free(results);
+    spatial_hash_free(hash);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+    DO_TEST(test_query_finds_overlapping)
+    DO_TEST(test_query_reports_once)
+    DO_TEST(test_remove)
+    DO_TEST(test_clear)
+    puts("spatial_hash_tests PASS");
+}